@@ -13,8 +13,10 @@ file(GLOB emp_game_common_src
   "fbpcs/emp_games/common/**.c"
   "fbpcs/emp_games/common/**.cpp"
   "fbpcs/emp_games/common/**.h"
-  "fbpcs/emp_games/common/**.hpp")
+  "fbpcs/emp_games/common/**.hpp"
+  "fbpcs/data_processing/common/Parsing.h")
 list(FILTER emp_game_common_src EXCLUDE REGEX ".*Test.*")
+list(FILTER emp_game_common_src EXCLUDE REGEX ".*Benchmark.*")
 add_library(empgamecommon STATIC
   ${emp_game_common_src})
 target_link_libraries(
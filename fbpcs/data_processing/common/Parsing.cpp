@@ -7,22 +7,19 @@
 
 #include "Parsing.h"
 
-#include <iomanip>
-#include <istream>
+#include <stdexcept>
 #include <string>
 
 #include <folly/logging/xlog.h>
 
 namespace private_lift::parsing {
 
-uint64_t parseStringToInt(const std::string& value) {
+uint64_t parseStringToInt(std::string_view value) {
   uint64_t parsed = 0;
-  std::istringstream iss{value};
-  iss >> parsed;
-  if (iss.fail()) {
+  if (!tryParseInt(value, parsed)) {
     XLOG(INFO) << value
                << " in input file is not a number. Please validate your input.";
-    throw std::out_of_range{iss.str()};
+    throw std::out_of_range{std::string{value}};
   }
   return parsed;
 }
@@ -5,10 +5,85 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <string>
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <folly/Conv.h>
+#include <folly/Range.h>
 
 namespace private_lift::parsing {
 
-uint64_t parseStringToInt(const std::string& value);
+namespace detail {
+inline bool isWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline std::string_view trimWhitespace(std::string_view value) {
+  while (!value.empty() && isWhitespace(value.front())) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && isWhitespace(value.back())) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+} // namespace detail
+
+/*
+ * Parse a base 10 integer that makes up all of value, ignoring surrounding
+ * whitespace and a leading '+'. This neither allocates nor throws, so it is
+ * meant to be called once per cell in input readers. Returns false and leaves
+ * out unchanged if value is empty, has any other characters or does not fit
+ * in T. bool only accepts 0 and 1.
+ */
+template <typename T>
+bool tryParseInt(std::string_view value, T& out) noexcept {
+  static_assert(std::is_integral_v<T>, "tryParseInt needs an integral type");
+  value = detail::trimWhitespace(value);
+  if (value.size() > 1 && value.front() == '+' && value[1] != '-') {
+    value.remove_prefix(1);
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    uint8_t parsed = 0;
+    if (!tryParseInt(value, parsed) || parsed > 1) {
+      return false;
+    }
+    out = parsed == 1;
+    return true;
+  } else {
+    T parsed = 0;
+    auto end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, parsed);
+    if (ec != std::errc{} || ptr != end) {
+      return false;
+    }
+    out = parsed;
+    return true;
+  }
+}
+
+/*
+ * Floating point counterpart of tryParseInt. Our libstdc++ has no floating
+ * point std::from_chars yet, so this goes through folly's double-conversion,
+ * which does not allocate either.
+ */
+inline bool tryParseDouble(std::string_view value, double& out) noexcept {
+  value = detail::trimWhitespace(value);
+  auto parsed =
+      folly::tryTo<double>(folly::StringPiece(value.data(), value.size()));
+  if (parsed.hasError()) {
+    return false;
+  }
+  out = parsed.value();
+  return true;
+}
+
+// Like tryParseInt, but logs and throws std::out_of_range on failure
+uint64_t parseStringToInt(std::string_view value);
 
 } // namespace private_lift::parsing
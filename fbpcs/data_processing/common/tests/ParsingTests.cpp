@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "fbpcs/data_processing/common/Parsing.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace private_lift::parsing {
+
+TEST(ParsingTests, TryParseIntAcceptsWholeValue) {
+  int64_t parsed = 0;
+  EXPECT_TRUE(tryParseInt("123", parsed));
+  EXPECT_EQ(parsed, 123);
+  EXPECT_TRUE(tryParseInt(" -42\r", parsed));
+  EXPECT_EQ(parsed, -42);
+  EXPECT_TRUE(tryParseInt("+7", parsed));
+  EXPECT_EQ(parsed, 7);
+}
+
+TEST(ParsingTests, TryParseIntRejectsInvalidValue) {
+  int64_t parsed = 5;
+  EXPECT_FALSE(tryParseInt("", parsed));
+  EXPECT_FALSE(tryParseInt("abc", parsed));
+  // the stream based parsing this replaces took the leading digits of these
+  EXPECT_FALSE(tryParseInt("12abc", parsed));
+  EXPECT_FALSE(tryParseInt("10.5", parsed));
+  EXPECT_FALSE(tryParseInt("+-1", parsed));
+  EXPECT_FALSE(tryParseInt("99999999999999999999", parsed));
+  EXPECT_EQ(parsed, 5);
+
+  uint32_t unsignedParsed = 0;
+  EXPECT_FALSE(tryParseInt("-1", unsignedParsed));
+  EXPECT_FALSE(tryParseInt("4294967296", unsignedParsed));
+}
+
+TEST(ParsingTests, TryParseIntBool) {
+  bool parsed = false;
+  EXPECT_TRUE(tryParseInt("1", parsed));
+  EXPECT_TRUE(parsed);
+  EXPECT_TRUE(tryParseInt("0", parsed));
+  EXPECT_FALSE(parsed);
+  EXPECT_FALSE(tryParseInt("2", parsed));
+}
+
+TEST(ParsingTests, TryParseDouble) {
+  double parsed = 0;
+  EXPECT_TRUE(tryParseDouble(" 1.5", parsed));
+  EXPECT_DOUBLE_EQ(parsed, 1.5);
+  EXPECT_TRUE(tryParseDouble("-2", parsed));
+  EXPECT_DOUBLE_EQ(parsed, -2.0);
+  EXPECT_FALSE(tryParseDouble("1.5x", parsed));
+  EXPECT_FALSE(tryParseDouble("", parsed));
+}
+
+TEST(ParsingTests, ParseStringToIntThrowsOnInvalidValue) {
+  EXPECT_EQ(parseStringToInt("18446744073709551615"), UINT64_MAX);
+  EXPECT_THROW(parseStringToInt("not a number"), std::out_of_range);
+}
+
+} // namespace private_lift::parsing
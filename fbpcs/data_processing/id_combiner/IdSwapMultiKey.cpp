@@ -29,6 +29,8 @@
 #include <folly/logging/xlog.h>
 #include <re2/re2.h>
 
+#include "../common/Parsing.h"
+
 namespace pid::combiner {
 void aggregateLiftNonIdColumns(
     std::vector<std::string> header,
@@ -54,14 +56,13 @@ void aggregateLiftNonIdColumns(
           << "Error: number of non-id columns not consistent with header.";
     }
     for (size_t col = 0; col < dRow.size(); ++col) {
-      try {
-        int32_t val = std::stoi(dRow[col]);
-        columnValues[col].push_back(val);
-      } catch (std::exception& err) {
+      int32_t val = 0;
+      if (!private_lift::parsing::tryParseInt(dRow[col], val)) {
         XLOG(FATAL)
-            << "Error: Exception caught during casting string to int.\n"
+            << "Error: Failed to parse " << dRow[col] << " to int.\n"
             << "\tFor PL, non-id columns has to be int to aggregate in case of duplicates.";
       }
+      columnValues[col].push_back(val);
     }
   }
 
@@ -10,11 +10,16 @@
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <istream>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "../common/Parsing.h"
 #include "DataPreparationHelpers.h"
 
 // TODO(T90086783): We should rely upon Csv.h to handle this sort of parsing for
@@ -38,6 +43,19 @@ std::vector<std::string> splitWithBrackets(const std::string& s) {
   res.push_back(s.substr(start));
   return res;
 }
+
+// Splits a "[a,b,c]" column into views of its elements
+void splitListInto(std::string_view s, std::vector<std::string_view>& res) {
+  res.clear();
+  auto inner = s.substr(1, s.size() - 2);
+  std::size_t start = 0;
+  for (std::size_t i = 0; i <= inner.size(); ++i) {
+    if (i == inner.size() || inner[i] == ',') {
+      res.push_back(inner.substr(start, i - start));
+      start = i + 1;
+    }
+  }
+}
 } // namespace
 
 namespace pid::combiner {
@@ -60,6 +78,27 @@ void sortIntegralValues(
   // Output the header as before
   outStream << vectorToString(header) << '\n';
 
+  // Look up the list columns once instead of for every row
+  std::vector<std::size_t> listIndices;
+  std::size_t sortByIdxInParsedLists = 0;
+  for (std::size_t i = 0; i < listColumns.size(); ++i) {
+    if (listColumns.at(i) == sortBy) {
+      sortByIdxInParsedLists = i;
+    }
+    listIndices.push_back(headerIndex(header, listColumns.at(i)));
+  }
+  // For every column, its position in listColumns or -1 if it is not a list
+  std::vector<int64_t> listPositions(headerSize, -1);
+  for (std::size_t i = 0; i < listIndices.size(); ++i) {
+    listPositions.at(listIndices.at(i)) = i;
+  }
+
+  // These are reused across rows, so that a row only allocates when it has
+  // more elements than any row before it
+  std::vector<std::vector<std::string_view>> listsInRow(listColumns.size());
+  std::vector<std::pair<int64_t, std::size_t>> sortKeys;
+  std::string outLine;
+
   while (getline(inStream, line)) {
     auto row = splitWithBrackets(line);
     auto rowSize = row.size();
@@ -72,63 +111,56 @@ void sortIntegralValues(
     }
 
     // First parse the listy columns
-    std::vector<std::vector<std::string>> listsInRow;
-    std::size_t sortByIdxInParsedLists;
-    std::size_t pushBackIdx = 0;
-    for (const auto& listCol : listColumns) {
-      if (listCol == sortBy) {
-        sortByIdxInParsedLists = pushBackIdx;
-      }
-      auto idx = headerIndex(header, listCol);
-      listsInRow.push_back(splitList(row.at(idx)));
-      ++pushBackIdx;
+    for (std::size_t i = 0; i < listIndices.size(); ++i) {
+      splitListInto(row.at(listIndices.at(i)), listsInRow.at(i));
     }
 
-    // We go ahead and parse the sortBy column once to avoid duplicating work
-    std::vector<int64_t> vals;
-    for (const auto& s : listsInRow.at(sortByIdxInParsedLists)) {
-      int64_t parsed;
-      std::istringstream parser{s};
-      parser >> parsed;
-      if (parser.fail()) {
-        XLOG(FATAL) << "Failed to parse " << s << " as int64_t";
+    // Sort the sortBy column by (value, position), which keeps elements with
+    // the same value in their input order, and use the resulting order for
+    // every list column. The elements are moved as text, so only the sortBy
+    // column is ever parsed.
+    sortKeys.clear();
+    const auto& sortByList = listsInRow.at(sortByIdxInParsedLists);
+    for (std::size_t j = 0; j < sortByList.size(); ++j) {
+      int64_t parsed = 0;
+      if (!private_lift::parsing::tryParseInt(sortByList.at(j), parsed)) {
+        XLOG(FATAL) << "Failed to parse " << sortByList.at(j) << " as int64_t";
       }
-      vals.push_back(parsed);
+      sortKeys.emplace_back(parsed, j);
     }
+    std::sort(sortKeys.begin(), sortKeys.end());
 
-    // Then sort them all based on the sortBy column
-    auto permutation =
-        getSortPermutation(vals, [](int64_t a, int64_t b) { return a < b; });
-    XLOG(INFO) << "The permutation of " << vectorToString(vals) << " is... "
-               << vectorToString(permutation);
+    // Finally, emit a new line
+    outLine.clear();
+    for (std::size_t i = 0; i < rowSize; ++i) {
+      if (i != 0) {
+        outLine.push_back(',');
+      }
 
-    // Apply the permutation to every list column
-    for (auto& lst : listsInRow) {
-      applyPermutation(lst, permutation);
-    }
+      auto listPosition = listPositions.at(i);
+      if (listPosition < 0) {
+        // Not a list column -- just output
+        outLine.append(row.at(i));
+        continue;
+      }
 
-    // Finally, emit a new line
-    bool first = true;
-    for (std::size_t i = 0; i < row.size(); ++i) {
-      if (!first) {
-        outStream << ',';
+      const auto& lst = listsInRow.at(listPosition);
+      if (lst.size() != sortKeys.size()) {
+        XLOG(FATAL) << "List column " << header.at(i) << " has " << lst.size()
+                    << " elements while " << sortBy << " has "
+                    << sortKeys.size() << "\nRow: " << line;
       }
-      first = false;
-
-      // If this is a list column, output from the sorted listsInRow instead
-      auto listFind =
-          std::find(listColumns.begin(), listColumns.end(), header.at(i));
-      if (listFind != listColumns.end()) {
-        outStream << '['
-                  << vectorToString(
-                         listsInRow.at(listFind - listColumns.begin()))
-                  << ']';
-      } else {
-        // Otherwise we have the "easy" case -- just output
-        outStream << row.at(i);
+      outLine.push_back('[');
+      for (std::size_t j = 0; j < sortKeys.size(); ++j) {
+        if (j != 0) {
+          outLine.push_back(',');
+        }
+        outLine.append(lst.at(sortKeys.at(j).second));
       }
+      outLine.push_back(']');
     }
-    outStream << '\n';
+    outLine.push_back('\n');
+    outStream << outLine;
   }
 }
 } // namespace pid::combiner
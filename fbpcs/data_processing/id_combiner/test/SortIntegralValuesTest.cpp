@@ -75,3 +75,25 @@ TEST_F(SortIntegralValuesTest, TestSortingBasic) {
       {"event_timestamps", "values"},
       expectedOutput);
 }
+
+// test that equal timestamps keep their input order and that columns which
+// are not listed are passed through as they are
+TEST_F(SortIntegralValuesTest, TestSortingTiesAndOtherColumns) {
+  std::vector<std::string> dataInput = {
+      "id_,values,cohort_id,event_timestamps,other",
+      "id_1,[1,2,3,4],7,[0,0,126,125],[9,8,7,6]",
+      "id_2,[5,6,7,8],3,[200,0,200,0],[1,2,3,4]",
+      "id_3,[9],1,[-5],[0]",
+  };
+  std::vector<std::string> expectedOutput = {
+      "id_,values,cohort_id,event_timestamps,other",
+      "id_1,[1,2,4,3],7,[0,0,125,126],[9,8,7,6]",
+      "id_2,[6,8,5,7],3,[0,0,200,200],[1,2,3,4]",
+      "id_3,[9],1,[-5],[0]",
+  };
+  runTest(
+      dataInput,
+      "event_timestamps",
+      {"values", "event_timestamps"},
+      expectedOutput);
+}
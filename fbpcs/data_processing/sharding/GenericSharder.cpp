@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <fstream>
@@ -26,6 +27,7 @@
 #include <fbpcf/io/api/FileWriter.h>
 #include <folly/Random.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <re2/re2.h>
 
@@ -51,8 +53,9 @@ void strRemoveBlanks(std::string& str) {
 }
 
 void strReplaceNullColumnWithEmpty(std::string& str) {
+  // Compiled once rather than for every line
+  static const re2::RE2 Regex("(^|,)(?i)null($|,)");
   std::string tmp = "";
-  re2::RE2 Regex("(^|,)(?i)null($|,)");
   while (tmp != str) {
     // in case there are overlapping matches, it would iterate to replace all
     // the null columns. e.g. null,null,null --> ,null, --> ,,
@@ -60,6 +63,13 @@ void strReplaceNullColumnWithEmpty(std::string& str) {
     re2::RE2::Replace(&str, Regex, "\\1\\2");
   }
 }
+
+void normalizeLine(std::string& line) {
+  stripQuotes(line);
+  dos2Unix(line);
+  strRemoveBlanks(line);
+  strReplaceNullColumnWithEmpty(line);
+}
 } // namespace detail
 
 static const std::string kIdColumnPrefix = "id_";
@@ -73,6 +83,13 @@ static const std::string kIdColumnPrefix = "id_";
 */
 static const uint64_t kBufferedWriterChunkSize = 5'242'880;
 
+/*
+  Number of input lines normalized by one worker thread at a time. At most
+  THREAD_POOL_SIZE batches are in flight, which bounds the memory we hold on
+  to while the writer catches up.
+*/
+static const std::size_t kLinesPerBatch = 10'000;
+
 std::vector<std::string> GenericSharder::genOutputPaths(
     const std::string& outputBasePath,
     std::size_t startIndex,
@@ -86,6 +103,7 @@ std::vector<std::string> GenericSharder::genOutputPaths(
 
 void GenericSharder::shard() {
   std::size_t numShards = getOutputPaths().size();
+  rowsInShard.resize(numShards);
   auto reader = std::make_unique<fbpcf::io::FileReader>(getInputPath());
   auto bufferedReader =
       std::make_unique<fbpcf::io::BufferedReader>(std::move(reader));
@@ -95,8 +113,8 @@ void GenericSharder::shard() {
   for (std::size_t i = 0; i < numShards; ++i) {
     auto fileWriter =
         std::make_unique<fbpcf::io::FileWriter>(getOutputPaths().at(i));
-    auto bufferedWriter =
-        std::make_unique<fbpcf::io::BufferedWriter>(std::move(fileWriter));
+    auto bufferedWriter = std::make_unique<fbpcf::io::BufferedWriter>(
+        std::move(fileWriter), kBufferedWriterChunkSize);
     outFiles.push_back(std::move(bufferedWriter));
     XLOG(INFO) << "Created buffered writer for shard " << std::to_string(i);
   }
@@ -134,21 +152,47 @@ void GenericSharder::shard() {
   }
   XLOG(INFO) << "Got header line: '" << line << "'";
 
-  // Read lines and send to appropriate outFile repeatedly
+  // Read lines and send to appropriate outFile repeatedly. Normalizing a line
+  // is the expensive part and does not depend on any other line, so batches
+  // of lines are normalized on a thread pool. The batches are still sharded
+  // one after another in input order, so stateful sharders (like round robin)
+  // produce exactly the same output as a sequential run.
   uint64_t lineIdx = 0;
+  auto shardBatch = [&](std::vector<std::string> batch) {
+    for (auto& batchLine : batch) {
+      shardLine(std::move(batchLine), outFiles, idColumnIndices);
+      ++lineIdx;
+      if (lineIdx % getLogRate() == 0) {
+        XLOG(INFO) << "Processed line "
+                   << private_lift::logging::formatNumber(lineIdx);
+      }
+    }
+  };
+
+  folly::CPUThreadPoolExecutor executor{THREAD_POOL_SIZE};
+  std::deque<folly::Future<std::vector<std::string>>> pendingBatches;
   while (!bufferedReader->eof()) {
-    line = bufferedReader->readLine();
-    detail::stripQuotes(line);
-    detail::dos2Unix(line);
-    detail::strRemoveBlanks(line);
-    detail::strReplaceNullColumnWithEmpty(line);
-    shardLine(std::move(line), outFiles, idColumnIndices);
-    ++lineIdx;
-    if (lineIdx % getLogRate() == 0) {
-      XLOG(INFO) << "Processed line "
-                 << private_lift::logging::formatNumber(lineIdx);
+    std::vector<std::string> batch;
+    batch.reserve(kLinesPerBatch);
+    while (batch.size() < kLinesPerBatch && !bufferedReader->eof()) {
+      batch.push_back(bufferedReader->readLine());
+    }
+    pendingBatches.push_back(
+        folly::via(&executor, [batch = std::move(batch)]() mutable {
+          for (auto& batchLine : batch) {
+            detail::normalizeLine(batchLine);
+          }
+          return std::move(batch);
+        }));
+    if (pendingBatches.size() > THREAD_POOL_SIZE) {
+      shardBatch(std::move(pendingBatches.front()).get());
+      pendingBatches.pop_front();
     }
   }
+  while (!pendingBatches.empty()) {
+    shardBatch(std::move(pendingBatches.front()).get());
+    pendingBatches.pop_front();
+  }
 
   // Log number of rows in each shard to the
   // "<filepath_for_0th_shard>_shardDistribution" file.
@@ -171,10 +215,11 @@ void GenericSharder::shardLine(
     std::string line,
     const std::vector<std::unique_ptr<fbpcf::io::BufferedWriter>>& outFiles,
     const std::vector<int32_t>& idColumnIndices) {
-  std::vector<std::string> cols;
+  // Split into views of line so that only the id column gets copied
+  std::vector<folly::StringPiece> cols;
   folly::split(",", line, cols);
 
-  std::string id = "";
+  folly::StringPiece id;
   for (auto idColumnIdx : idColumnIndices) {
     if (idColumnIdx >= cols.size()) {
       XLOG_EVERY_MS(INFO, 5000)
@@ -191,11 +236,10 @@ void GenericSharder::shardLine(
     XLOG_EVERY_MS(INFO, 5000) << "All the id values are empty in this row";
     return;
   }
-  auto shard = getShardFor(id, outFiles.size());
+  auto shard = getShardFor(id.str(), outFiles.size());
   logRowsToShard(shard);
-  std::string newLine = "\n";
+  line.push_back('\n');
   outFiles.at(shard)->writeString(line);
-  outFiles.at(shard)->writeString(newLine);
 }
 
 void GenericSharder::logShardDistribution() {
@@ -222,7 +266,10 @@ void GenericSharder::logShardDistribution() {
 }
 
 std::string GenericSharder::getShardDistributionJson() {
-  auto rowsInShardDynamic = folly::toDynamic(rowsInShard);
+  auto rowsInShardDynamic = folly::dynamic::object();
+  for (std::size_t shard = 0; shard < rowsInShard.size(); ++shard) {
+    rowsInShardDynamic[std::to_string(shard)] = rowsInShard[shard];
+  }
   std::string shardDstributionStr = folly::toPrettyJson(rowsInShardDynamic);
   return shardDstributionStr;
 }
@@ -11,7 +11,6 @@
 #include <memory>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include <fbpcf/io/api/BufferedWriter.h>
@@ -32,6 +31,14 @@ void stripQuotes(std::string& s);
  * @param s the string from which to remove dos line ending characters
  */
 void dos2Unix(std::string& s);
+
+/**
+ * Apply every clean-up step we run on input rows before sharding them: strip
+ * quotes, dos line endings and blanks and empty out "null" columns.
+ *
+ * @param line the input row to normalize in place
+ */
+void normalizeLine(std::string& line);
 } // namespace detail
 
 constexpr int THREAD_POOL_SIZE = 20;
@@ -129,17 +136,17 @@ class GenericSharder {
   }
 
   void logRowsToShard(std::size_t shard) {
-    std::stringstream ss;
-    ss << shard;
-    std::string key = ss.str();
-    rowsInShard[key]++;
+    if (shard >= rowsInShard.size()) {
+      rowsInShard.resize(shard + 1);
+    }
+    rowsInShard[shard]++;
   }
 
   int getRowsForShard(std::size_t shard) {
-    std::stringstream ss;
-    ss << shard;
-    std::string key = ss.str();
-    return rowsInShard[key];
+    if (shard >= rowsInShard.size()) {
+      rowsInShard.resize(shard + 1);
+    }
+    return rowsInShard[shard];
   }
 
   /**
@@ -186,6 +193,6 @@ class GenericSharder {
   std::string inputPath_;
   std::vector<std::string> outputPaths_;
   int32_t logEveryN_;
-  std::unordered_map<std::string, int> rowsInShard;
+  std::vector<int> rowsInShard;
 };
 } // namespace data_processing::sharder
@@ -9,9 +9,11 @@
 #include <string>
 #include <vector>
 
+#include <folly/Random.h>
 #include <gtest/gtest.h>
 
 #include "fbpcs/data_processing/sharding/RoundRobinBasedSharder.h"
+#include "fbpcs/data_processing/test_utils/FileIOTestUtils.h"
 
 namespace data_processing::sharder {
 TEST(RoundRobinBasedSharderTest, TestGetShardFor) {
@@ -21,4 +23,41 @@ TEST(RoundRobinBasedSharderTest, TestGetShardFor) {
   EXPECT_EQ(0, sharder.getShardFor("baz", 2));
   EXPECT_EQ(1, sharder.getShardFor("quux", 2));
 }
+
+TEST(RoundRobinBasedSharderTest, TestShardKeepsOrderAcrossBatches) {
+  // Enough rows to be split into several batches that are normalized in
+  // parallel. The output must still match a sequential round robin.
+  auto randStart = folly::Random::secureRand64();
+  std::string inputPath =
+      "/tmp/RoundRobinBasedSharderTestInput" + std::to_string(randStart);
+  std::size_t numShards = 3;
+  auto outputPaths = GenericSharder::genOutputPaths(
+      "/tmp/RoundRobinBasedSharderTestOutput" + std::to_string(randStart),
+      0,
+      numShards);
+
+  std::vector<std::string> rows{"id_,value"};
+  std::vector<std::vector<std::string>> expected(
+      numShards, std::vector<std::string>{"id_,value"});
+  std::size_t shard = 0;
+  for (std::size_t i = 0; i < 45'000; ++i) {
+    if (i % 1000 == 0) {
+      // Rows without an id are dropped and do not advance the round robin
+      rows.push_back(",NULL");
+      continue;
+    }
+    rows.push_back("\"id" + std::to_string(i) + "\", " + std::to_string(i));
+    expected.at(shard).push_back(
+        "id" + std::to_string(i) + "," + std::to_string(i));
+    shard = (shard + 1) % numShards;
+  }
+  data_processing::test_utils::writeVecToFile(rows, inputPath);
+
+  RoundRobinBasedSharder sharder{inputPath, outputPaths, 10'000};
+  sharder.shard();
+  for (std::size_t i = 0; i < numShards; ++i) {
+    data_processing::test_utils::expectFileRowsEqual(
+        outputPaths.at(i), expected.at(i));
+  }
+}
 } // namespace data_processing::sharder
@@ -12,6 +12,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include "folly/logging/xlog.h"
+
+#include "fbpcs/data_processing/common/Parsing.h"
 #include "fbpcs/emp_games/attribution/decoupled_aggregation/Aggregator.h"
 #include "fbpcs/emp_games/attribution/decoupled_aggregation/AttributionResult.h"
 #include "fbpcs/emp_games/attribution/decoupled_aggregation/ConversionMetadata.h"
@@ -37,8 +40,9 @@ static const std::vector<T> getInnerArray(std::string& str) {
   for (const auto& innerVal : innerVals) {
     if (!innerVal.empty()) {
       T parsed = 0;
-      std::istringstream iss{innerVal};
-      iss >> parsed;
+      if (!private_lift::parsing::tryParseInt(innerVal, parsed)) {
+        XLOGF(ERR, "Error: failed to parse {}", innerVal);
+      }
       out.push_back(parsed);
     }
   }
@@ -7,10 +7,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <fbpcf/io/api/FileIOWrappers.h>
+#include <fbpcf/io/api/BufferedWriter.h>
+#include <fbpcf/io/api/FileWriter.h>
 #include <fbpcf/mpc/EmpApp.h>
 #include <fbpcf/mpc/EmpGame.h>
 
@@ -85,7 +87,11 @@ class AttributionApp
   }
 
   void putOutputData(const AttributionOutputMetrics& attributions) override {
-    fbpcf::io::FileIOWrappers::writeFile(outputPath_, attributions.toJson());
+    auto fileWriter = std::make_unique<fbpcf::io::FileWriter>(outputPath_);
+    auto bufferedWriter =
+        std::make_unique<fbpcf::io::BufferedWriter>(std::move(fileWriter));
+    attributions.writeJson(*bufferedWriter);
+    bufferedWriter->close();
   }
 
  private:
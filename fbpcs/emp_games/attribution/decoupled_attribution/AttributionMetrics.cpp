@@ -17,6 +17,7 @@
 #include "folly/json.h"
 #include "folly/logging/xlog.h"
 
+#include "fbpcs/data_processing/common/Parsing.h"
 #include "fbpcs/emp_games/common/Csv.h"
 
 #include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionMetrics.h"
@@ -40,8 +41,9 @@ static const std::vector<int64_t> getInnerArray(std::string& str) {
   for (const auto& innerVal : innerVals) {
     if (!innerVal.empty()) {
       int64_t parsed = 0;
-      std::istringstream iss{innerVal};
-      iss >> parsed;
+      if (!private_lift::parsing::tryParseInt(innerVal, parsed)) {
+        XLOGF(ERR, "Error: failed to parse {}", innerVal);
+      }
       out.push_back(parsed);
     }
   }
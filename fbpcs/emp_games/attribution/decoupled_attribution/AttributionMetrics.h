@@ -18,6 +18,7 @@
 #include <folly/dynamic.h>
 #include <folly/json.h>
 
+#include <fbpcf/io/api/BufferedWriter.h>
 #include <fbpcf/mpc/EmpGame.h>
 #include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionOutput.h"
 #include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionRule.h"
@@ -69,10 +70,9 @@ struct AttributionMetrics {
 
   folly::dynamic toDynamic() const {
     folly::dynamic res = folly::dynamic::object();
-    for (auto kv : formatToAttribution) {
-      auto attributionName = kv.first;
-      auto attributionMetrics = kv.second;
-      res.insert(attributionName, attributionMetrics);
+    for (const auto& [attributionName, attributionResult] :
+         formatToAttribution) {
+      res.insert(attributionName, attributionResult.toDynamic());
     }
 
     return res;
@@ -82,14 +82,12 @@ struct AttributionMetrics {
     std::unordered_map<std::string, AttributionResult> formatToAttribution;
     for (auto& pair : obj.items()) {
       auto attributionName = pair.first.asString();
-      auto attributionMetrics = pair.second;
-      std::pair<std::string, AttributionResult> t{
-          attributionName, attributionMetrics};
-      formatToAttribution.insert(t);
+      formatToAttribution.emplace(
+          attributionName, AttributionResult::fromDynamic(pair.second));
     }
 
     AttributionMetrics metrics{};
-    metrics.formatToAttribution = formatToAttribution;
+    metrics.formatToAttribution = std::move(formatToAttribution);
 
     return metrics;
   }
@@ -103,6 +101,25 @@ struct AttributionMetrics {
     auto obj = folly::parseJson(str);
     return fromDynamic(obj);
   }
+
+  void writeJson(fbpcf::io::BufferedWriter& writer) const {
+    std::string buffer = "{";
+    bool first = true;
+    for (const auto& [attributionName, attributionResult] :
+         formatToAttribution) {
+      if (!first) {
+        buffer.push_back(',');
+      }
+      first = false;
+      buffer.append(folly::toJson(attributionName));
+      buffer.push_back(':');
+      writer.writeString(buffer);
+      attributionResult.writeJson(writer);
+      buffer.clear();
+    }
+    buffer.push_back('}');
+    writer.writeString(buffer);
+  }
 };
 
 struct AttributionOutputMetrics {
@@ -144,6 +161,27 @@ struct AttributionOutputMetrics {
     auto obj = folly::parseJson(str);
     return fromDynamic(obj);
   }
+
+  /*
+   * Stream the output as compact JSON, one attribution result at a time.
+   */
+  void writeJson(fbpcf::io::BufferedWriter& writer) const {
+    std::string buffer = "{";
+    bool first = true;
+    for (const auto& [ruleName, metrics] : ruleToMetrics) {
+      if (!first) {
+        buffer.push_back(',');
+      }
+      first = false;
+      buffer.append(folly::toJson(ruleName));
+      buffer.push_back(':');
+      writer.writeString(buffer);
+      metrics.writeJson(writer);
+      buffer.clear();
+    }
+    buffer.push_back('}');
+    writer.writeString(buffer);
+  }
 };
 
 class PrivateAttributionMetrics {
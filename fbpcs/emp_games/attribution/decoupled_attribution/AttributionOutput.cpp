@@ -8,35 +8,18 @@
 #include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionOutput.h"
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include "folly/Conv.h"
 #include "folly/dynamic.h"
 
 namespace aggregation::private_attribution {
 
-using PrivateAttDefaultMap = std::vector<PrivateOutputMetricDefault>;
-
 namespace {
 
-struct AttributionDefaultFmt {
-  std::unordered_map<int64_t, std::vector<OutputMetricDefault>> idToMetrics;
-
-  folly::dynamic toDynamic() const {
-    folly::dynamic res = folly::dynamic::object();
-
-    for (const auto& [k1, v1] : idToMetrics) {
-      auto uid = std::to_string(k1);
-      folly::dynamic metricList = folly::dynamic::array();
-      for (const auto& metric : v1) {
-        metricList.push_back(metric.toDynamic());
-      }
-      res.insert(uid, metricList);
-    }
-    return res;
-  }
-};
-
 class AttributionDefault : public AttributionOutput {
  public:
   explicit AttributionDefault(
@@ -48,8 +31,13 @@ class AttributionDefault : public AttributionOutput {
     CHECK_EQ(uids.size(), touchpoints.size())
         << "uid array and touchpoint array must be equal size";
 
+    uids_.reserve(uids.size());
+    metrics_.reserve(uids.size());
     for (std::vector<int64_t>::size_type i = 0; i < uids.size(); i++) {
-      idToMetrics_.emplace(uids[i], PrivateAttDefaultMap{});
+      if (uidToIndex_.emplace(uids[i], uids_.size()).second) {
+        uids_.push_back(uids[i]);
+        metrics_.emplace_back();
+      }
     }
   }
 
@@ -57,42 +45,114 @@ class AttributionDefault : public AttributionOutput {
     const emp::Bit true_bit{true, emp::PUBLIC};
     const emp::Bit false_bit{false, emp::PUBLIC};
 
-    PrivateAttDefaultMap& metrics = idToMetrics_[attribution.uid];
-    PrivateOutputMetricDefault metric{
-        emp::If(attribution.hasAttributedTouchpoint, true_bit, false_bit)};
-    metrics.push_back(metric);
+    auto [it, inserted] = uidToIndex_.emplace(attribution.uid, uids_.size());
+    if (inserted) {
+      uids_.push_back(attribution.uid);
+      metrics_.emplace_back();
+    }
+    metrics_.at(it->second).push_back(PrivateOutputMetricDefault{
+        emp::If(attribution.hasAttributedTouchpoint, true_bit, false_bit)});
   }
 
   virtual AttributionResult reveal() const override {
-    AttributionDefaultFmt out;
-
-    for (const auto& [uid, privateIdToMetric] : idToMetrics_) {
-      XLOGF(
-          DBG,
-          "Revealing attribution metrics for rule={} uid={}",
-          attributionRule_.name,
-          uid);
-
-      std::vector<OutputMetricDefault> revealedMetric;
-      for (const auto& metric : privateIdToMetric) {
-        IF_OMNISCIENT_MODE {
-          revealedMetric.emplace_back(metric.reveal(fbpcf::Visibility::Public));
-        }
-        else {
-          revealedMetric.emplace_back(metric.reveal(outputVisibility_));
-        }
+    XLOGF(
+        DBG,
+        "Revealing attribution metrics for rule={} in one batch",
+        attributionRule_.name);
+
+    AttributionResult out;
+    out.uids = uids_;
+    out.uidOffsets.reserve(uids_.size() + 1);
+
+    std::vector<emp::block> labels;
+    for (const auto& metrics : metrics_) {
+      for (const auto& metric : metrics) {
+        labels.push_back(metric.is_attributed.bit);
       }
-      out.idToMetrics.emplace(uid, revealedMetric);
+      out.uidOffsets.push_back(labels.size());
+    }
+
+    int party =
+        outputVisibility_ == fbpcf::Visibility::Xor ? emp::XOR : emp::PUBLIC;
+    IF_OMNISCIENT_MODE {
+      party = emp::PUBLIC;
     }
-    return out.toDynamic();
+
+    // Reveal every bit of this rule in a single round instead of one round
+    // per metric
+    auto revealed = std::make_unique<bool[]>(labels.size());
+    if (!labels.empty()) {
+      emp::ProtocolExecution::prot_exec->reveal(
+          revealed.get(), party, labels.data(), labels.size());
+    }
+    out.isAttributed.assign(revealed.get(), revealed.get() + labels.size());
+    return out;
   }
 
  private:
-  std::unordered_map<int64_t, PrivateAttDefaultMap> idToMetrics_;
+  std::vector<int64_t> uids_;
+  std::unordered_map<int64_t, size_t> uidToIndex_;
+  std::vector<std::vector<PrivateOutputMetricDefault>> metrics_;
 };
 
 } // namespace
 
+folly::dynamic AttributionResult::toDynamic() const {
+  folly::dynamic res = folly::dynamic::object();
+
+  for (size_t i = 0; i < uids.size(); ++i) {
+    folly::dynamic metricList = folly::dynamic::array();
+    for (auto j = uidOffsets.at(i); j < uidOffsets.at(i + 1); ++j) {
+      metricList.push_back(
+          OutputMetricDefault{isAttributed.at(j)}.toDynamic());
+    }
+    res.insert(std::to_string(uids.at(i)), std::move(metricList));
+  }
+  return res;
+}
+
+AttributionResult AttributionResult::fromDynamic(const folly::dynamic& obj) {
+  AttributionResult out;
+  for (const auto& [uid, metricList] : obj.items()) {
+    for (const auto& metric : metricList) {
+      out.isAttributed.push_back(
+          OutputMetricDefault::fromDynamic(metric).is_attributed);
+    }
+    out.uids.push_back(folly::to<int64_t>(uid.asString()));
+    out.uidOffsets.push_back(out.isAttributed.size());
+  }
+  return out;
+}
+
+void AttributionResult::writeJson(fbpcf::io::BufferedWriter& writer) const {
+  std::string buffer;
+  buffer.reserve(kJsonChunkSize + 256);
+  buffer.push_back('{');
+  for (size_t i = 0; i < uids.size(); ++i) {
+    if (i > 0) {
+      buffer.push_back(',');
+    }
+    buffer.push_back('"');
+    folly::toAppend(uids.at(i), &buffer);
+    buffer.append("\":[");
+    for (auto j = uidOffsets.at(i); j < uidOffsets.at(i + 1); ++j) {
+      if (j > uidOffsets.at(i)) {
+        buffer.push_back(',');
+      }
+      buffer.append(
+          isAttributed.at(j) ? "{\"is_attributed\":true}"
+                             : "{\"is_attributed\":false}");
+    }
+    buffer.push_back(']');
+    if (buffer.size() >= kJsonChunkSize) {
+      writer.writeString(buffer);
+      buffer.clear();
+    }
+  }
+  buffer.push_back('}');
+  writer.writeString(buffer);
+}
+
 static const std::array SUPPORTED_ATTRIBUTION_FORMATS{
     AttributionFormat{
         /* id */ 1,
@@ -8,10 +8,13 @@
 #pragma once
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include <folly/dynamic.h>
 #include <cstdlib>
 
+#include <fbpcf/io/api/BufferedWriter.h>
 #include <fbpcf/mpc/EmpGame.h>
 #include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionRule.h"
 #include "fbpcs/emp_games/attribution/decoupled_attribution/Conversion.h"
@@ -61,7 +64,26 @@ struct PrivateOutputMetricDefault {
   }
 };
 
-using AttributionResult = folly::dynamic;
+/*
+ * Revealed attribution results of one attribution format, kept as flat
+ * columns. The metrics of uids[i] are at positions
+ * [uidOffsets[i], uidOffsets[i + 1]) of isAttributed.
+ */
+struct AttributionResult {
+  static constexpr size_t kJsonChunkSize = 1 << 20;
+
+  std::vector<int64_t> uids;
+  std::vector<uint64_t> uidOffsets{0};
+  std::vector<bool> isAttributed;
+
+  folly::dynamic toDynamic() const;
+  static AttributionResult fromDynamic(const folly::dynamic& obj);
+
+  // Write the same JSON object as folly::toJson(toDynamic()) without
+  // building the intermediate dynamic tree, in chunks of about
+  // kJsonChunkSize bytes
+  void writeJson(fbpcf::io::BufferedWriter& writer) const;
+};
 
 class AttributionOutput {
  public:
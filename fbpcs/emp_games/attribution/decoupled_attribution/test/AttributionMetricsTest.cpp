@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fbpcf/io/api/BufferedWriter.h>
+#include <fbpcf/io/api/FileIOWrappers.h>
+#include <fbpcf/io/api/FileWriter.h>
+#include "folly/Format.h"
+#include "folly/Random.h"
+#include "folly/dynamic.h"
+#include "folly/json.h"
+
+#include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionMetrics.h"
+#include "fbpcs/emp_games/attribution/decoupled_attribution/AttributionOutput.h"
+#include "fbpcs/emp_games/common/TestUtil.h"
+
+namespace aggregation::private_attribution {
+
+class AttributionMetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    baseDir_ = private_measurement::test_util::getBaseDirFromPath(__FILE__);
+    std::string tempDir = std::filesystem::temp_directory_path();
+    outputPath_ = folly::sformat(
+        "{}/attribution_metrics.json_{}",
+        tempDir,
+        folly::Random::secureRand64());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(outputPath_);
+  }
+
+  // Streams the JSON of obj to a file and returns the file content
+  template <typename T>
+  std::string writeJson(const T& obj) {
+    auto fileWriter = std::make_unique<fbpcf::io::FileWriter>(outputPath_);
+    auto bufferedWriter =
+        std::make_unique<fbpcf::io::BufferedWriter>(std::move(fileWriter));
+    obj.writeJson(*bufferedWriter);
+    bufferedWriter->close();
+    return fbpcf::io::FileIOWrappers::readFile(outputPath_);
+  }
+
+  std::string baseDir_;
+  std::string outputPath_;
+};
+
+TEST_F(AttributionMetricsTest, TestAttributionResultColumns) {
+  AttributionResult result;
+  result.uids = {7, -3, 12};
+  result.uidOffsets = {0, 2, 2, 3};
+  result.isAttributed = {true, false, true};
+
+  auto expected = folly::parseJson(R"({
+    "7": [{"is_attributed": true}, {"is_attributed": false}],
+    "-3": [],
+    "12": [{"is_attributed": true}]
+  })");
+  EXPECT_EQ(result.toDynamic(), expected);
+
+  auto parsed = AttributionResult::fromDynamic(expected);
+  EXPECT_EQ(parsed.toDynamic(), expected);
+  ASSERT_EQ(parsed.uids.size(), 3);
+  ASSERT_EQ(parsed.uidOffsets.size(), 4);
+  EXPECT_EQ(parsed.uidOffsets.back(), 3);
+  EXPECT_EQ(parsed.isAttributed.size(), 3);
+
+  EXPECT_EQ(writeJson(AttributionResult{}), "{}");
+}
+
+TEST_F(AttributionMetricsTest, TestAttributionResultWriteJson) {
+  // large enough to span several chunks of the streamed output
+  AttributionResult result;
+  for (int64_t uid = 0; uid < 200000; ++uid) {
+    for (int64_t i = 0; i < uid % 3; ++i) {
+      result.isAttributed.push_back((uid + i) % 5 == 0);
+    }
+    result.uids.push_back(uid);
+    result.uidOffsets.push_back(result.isAttributed.size());
+  }
+
+  auto json = writeJson(result);
+  EXPECT_GT(json.size(), 2 * AttributionResult::kJsonChunkSize);
+  EXPECT_EQ(json.find('\n'), std::string::npos);
+  EXPECT_EQ(folly::parseJson(json), result.toDynamic());
+}
+
+// The expected outputs were written by the old pretty-printed toJson(), the
+// streamed compact output has to parse to the same value.
+TEST_F(AttributionMetricsTest, TestJsonRoundTripAgainstOldOutput) {
+  for (const auto& rule : {"last_click_1d", "last_touch_1d"}) {
+    auto oldOutput = fbpcf::io::FileIOWrappers::readFile(
+        baseDir_ + "test_correctness/" + rule + ".json");
+    auto expected = folly::parseJson(oldOutput);
+
+    auto metrics = AttributionOutputMetrics::fromJson(oldOutput);
+    EXPECT_EQ(metrics.toDynamic(), expected);
+    EXPECT_EQ(folly::parseJson(metrics.toJson()), expected);
+
+    auto json = writeJson(metrics);
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+    EXPECT_EQ(folly::parseJson(json), expected);
+    EXPECT_EQ(AttributionOutputMetrics::fromJson(json).toDynamic(), expected);
+  }
+}
+
+} // namespace aggregation::private_attribution
@@ -157,9 +157,10 @@ revealXORedResult(
 
   // Attribution output contains results based on attribution format (currently
   // only "default").
-  AttributionResult aliceAttribution =
-      aliceAttributionOutput.at(attributionFormat);
-  AttributionResult bobAttribution = bobAttributionOutput.at(attributionFormat);
+  folly::dynamic aliceAttribution =
+      aliceAttributionOutput.at(attributionFormat).toDynamic();
+  folly::dynamic bobAttribution =
+      bobAttributionOutput.at(attributionFormat).toDynamic();
 
   // first sort the keys so that alice and bob are reading
   // corresponding rows
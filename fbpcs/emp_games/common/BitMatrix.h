@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+/**
+ * Dense bit matrix packed into 64 bit words, row by row. Bit c of a row is bit
+ * c % 64 of word c / 64 of that row, and the unused bits of the last word of
+ * every row are kept zero. This is the layout batched secret bits are
+ * transposed in: converting between rows of std::vector<bool> and columns of
+ * std::vector<bool> one element at a time goes through the vector<bool> proxy
+ * for every bit and strides across all the columns, while the blocked
+ * transpose below moves 64 x 64 bits with a few word operations, and rows are
+ * copied in and out of std::vector<bool> a word at a time.
+ */
+class BitMatrix {
+ public:
+  static constexpr size_t kWordBits = 64;
+
+  BitMatrix(size_t numRows, size_t numCols)
+      : numRows_{numRows},
+        numCols_{numCols},
+        wordsPerRow_{(numCols + kWordBits - 1) / kWordBits},
+        words_(numRows * wordsPerRow_, 0) {}
+
+  size_t numRows() const {
+    return numRows_;
+  }
+
+  size_t numCols() const {
+    return numCols_;
+  }
+
+  bool get(size_t row, size_t col) const {
+    return (words_[row * wordsPerRow_ + col / kWordBits] >>
+            (col % kWordBits)) &
+        1;
+  }
+
+  void set(size_t row, size_t col, bool value) {
+    auto& word = words_[row * wordsPerRow_ + col / kWordBits];
+    auto mask = uint64_t{1} << (col % kWordBits);
+    word = value ? (word | mask) : (word & ~mask);
+  }
+
+  /**
+   * Packs rows into a numRows by numCols matrix. Rows may be missing or
+   * shorter than numCols, the missing entries are set to paddingValue and
+   * entries beyond numCols are ignored.
+   */
+  static BitMatrix fromRows(
+      const std::vector<std::vector<bool>>& rows,
+      size_t numRows,
+      size_t numCols,
+      bool paddingValue = false) {
+    BitMatrix matrix(numRows, numCols);
+    for (size_t row = 0; row < numRows; ++row) {
+      size_t available = row < rows.size() ? std::min(rows[row].size(), numCols)
+                                           : 0;
+      uint64_t* words = matrix.words_.data() + row * matrix.wordsPerRow_;
+      if (available > 0) {
+        packWords(rows[row], available, words);
+      }
+      if (paddingValue) {
+        setBits(words, available, numCols);
+      }
+    }
+    return matrix;
+  }
+
+  std::vector<std::vector<bool>> toRows() const {
+    std::vector<std::vector<bool>> rows;
+    rows.reserve(numRows_);
+    for (size_t row = 0; row < numRows_; ++row) {
+      rows.push_back(unpackWords(words_.data() + row * wordsPerRow_, numCols_));
+    }
+    return rows;
+  }
+
+  // Returns the numCols by numRows transpose, computed in 64 x 64 blocks.
+  BitMatrix transpose() const {
+    BitMatrix result(numCols_, numRows_);
+    std::array<uint64_t, kWordBits> block;
+    for (size_t rowWord = 0; rowWord < result.wordsPerRow_; ++rowWord) {
+      size_t rowBegin = rowWord * kWordBits;
+      size_t rowsInBlock = std::min(kWordBits, numRows_ - rowBegin);
+      for (size_t colWord = 0; colWord < wordsPerRow_; ++colWord) {
+        size_t colBegin = colWord * kWordBits;
+        size_t colsInBlock = std::min(kWordBits, numCols_ - colBegin);
+        for (size_t i = 0; i < kWordBits; ++i) {
+          block[i] =
+              i < rowsInBlock ? words_[(rowBegin + i) * wordsPerRow_ + colWord]
+                              : 0;
+        }
+        transposeBlock(block);
+        for (size_t i = 0; i < colsInBlock; ++i) {
+          result.words_[(colBegin + i) * result.wordsPerRow_ + rowWord] =
+              block[i];
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * In place transpose of a 64 x 64 block, where bit j of block[i] is entry
+   * (i, j). The off-diagonal halves are swapped recursively, from 32 x 32
+   * quadrants down to single bits, with masked shifts on whole words (see
+   * Hacker's Delight, 7-3).
+   */
+  static void transposeBlock(std::array<uint64_t, kWordBits>& block) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (size_t width = 32; width != 0; width >>= 1, mask ^= mask << width) {
+      for (size_t k = 0; k < kWordBits; k = ((k | width) + 1) & ~width) {
+        uint64_t swapped = ((block[k] >> width) ^ block[k | width]) & mask;
+        block[k] ^= swapped << width;
+        block[k | width] ^= swapped;
+      }
+    }
+  }
+
+ private:
+  /*
+   * libstdc++ stores std::vector<bool> in the same layout as a BitMatrix row,
+   * bit i being bit i % 64 of word i / 64, so with it whole words are copied.
+   * Anything else goes through the vector<bool> proxies one bit at a time.
+   */
+#if defined(__GLIBCXX__)
+  static constexpr bool kCopyWords = sizeof(std::_Bit_type) == sizeof(uint64_t);
+#else
+  static constexpr bool kCopyWords = false;
+#endif
+
+  // Packs the first numBits bits of bits into words, which are all zero
+  static void
+  packWords(const std::vector<bool>& bits, size_t numBits, uint64_t* words) {
+    if constexpr (kCopyWords) {
+      const auto* source = bits.begin()._M_p;
+      size_t fullWords = numBits / kWordBits;
+      std::copy(source, source + fullWords, words);
+      if (numBits % kWordBits != 0) {
+        words[fullWords] =
+            source[fullWords] & lowBitsMask(numBits % kWordBits);
+      }
+    } else {
+      for (size_t i = 0; i < numBits; ++i) {
+        words[i / kWordBits] |= uint64_t{bits[i]} << (i % kWordBits);
+      }
+    }
+  }
+
+  static std::vector<bool> unpackWords(const uint64_t* words, size_t numBits) {
+    std::vector<bool> bits(numBits);
+    if constexpr (kCopyWords) {
+      std::copy(
+          words,
+          words + (numBits + kWordBits - 1) / kWordBits,
+          bits.begin()._M_p);
+    } else {
+      for (size_t i = 0; i < numBits; ++i) {
+        bits[i] = (words[i / kWordBits] >> (i % kWordBits)) & 1;
+      }
+    }
+    return bits;
+  }
+
+  // Sets bits [begin, end) of words
+  static void setBits(uint64_t* words, size_t begin, size_t end) {
+    while (begin < end) {
+      size_t wordEnd = std::min(end, (begin / kWordBits + 1) * kWordBits);
+      words[begin / kWordBits] |=
+          lowBitsMask(wordEnd - begin) << (begin % kWordBits);
+      begin = wordEnd;
+    }
+  }
+
+  // The numBits lowest bits, 0 < numBits <= 64
+  static uint64_t lowBitsMask(size_t numBits) {
+    return numBits == kWordBits ? ~uint64_t{0}
+                                : (uint64_t{1} << numBits) - 1;
+  }
+
+  size_t numRows_;
+  size_t numCols_;
+  size_t wordsPerRow_;
+  std::vector<uint64_t> words_;
+};
+
+} // namespace common
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <fbpcf/engine/communication/IPartyCommunicationAgent.h>
+
+#include "fbpcs/emp_games/common/Constants.h"
+
+namespace common {
+
+/*
+ * A queue of file indices [0, numFiles) shared by all worker threads of one
+ * party. Each call to next() hands out a distinct index until all files are
+ * taken.
+ */
+class FileIndexQueue {
+ public:
+  explicit FileIndexQueue(std::size_t numFiles) : numFiles_{numFiles} {}
+
+  std::optional<std::size_t> next() {
+    auto index = nextIndex_.fetch_add(1);
+    if (index >= numFiles_) {
+      return std::nullopt;
+    }
+    return index;
+  }
+
+ private:
+  const std::size_t numFiles_;
+  std::atomic<std::size_t> nextIndex_{0};
+};
+
+/*
+ * Assigns files to one long-lived game worker on demand. The publisher and
+ * partner workers that share a scheduler must process the same file, so only
+ * the publisher draws from the FileIndexQueue and forwards each index to its
+ * partner worker; the partner worker just receives them. This keeps all
+ * workers busy when shard sizes vary while both parties stay in lockstep.
+ */
+class FileAssigner {
+ public:
+  FileAssigner(
+      int myRole,
+      std::shared_ptr<FileIndexQueue> queue,
+      std::unique_ptr<fbpcf::engine::communication::IPartyCommunicationAgent>
+          agent)
+      : myRole_{myRole}, queue_{std::move(queue)}, agent_{std::move(agent)} {}
+
+  /*
+   * Return the index of the next file this worker should process, or
+   * std::nullopt once every file has been handed out.
+   */
+  std::optional<std::size_t> next() {
+    if (myRole_ == PUBLISHER) {
+      auto index = queue_->next();
+      uint64_t message = index.has_value() ? static_cast<uint64_t>(*index)
+                                           : kNoMoreFiles;
+      std::vector<unsigned char> data(sizeof(message));
+      std::memcpy(data.data(), &message, sizeof(message));
+      agent_->send(data);
+      return index;
+    } else {
+      auto data = agent_->receive(sizeof(uint64_t));
+      uint64_t message;
+      std::memcpy(&message, data.data(), sizeof(message));
+      if (message == kNoMoreFiles) {
+        return std::nullopt;
+      }
+      return static_cast<std::size_t>(message);
+    }
+  }
+
+ private:
+  static constexpr uint64_t kNoMoreFiles = std::numeric_limits<uint64_t>::max();
+
+  int myRole_;
+  std::shared_ptr<FileIndexQueue> queue_;
+  std::unique_ptr<fbpcf::engine::communication::IPartyCommunicationAgent>
+      agent_;
+};
+
+} // namespace common
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/dynamic.h>
+
+namespace common {
+
+/**
+ * Compact binary encoding of a metrics tree, i.e. nested dicts and lists with
+ * int64 leaves, which is what aggregation writes per shard and the shard
+ * combiner reads back. The layout is
+ *
+ *   magic (kMetricsBinaryMagic), version byte
+ *   varint number of distinct dict keys, each key as varint length + bytes
+ *   the root node
+ *
+ * where a node is a MetricsNodeType byte followed by a little endian int64
+ * for a value, a varint size and the elements for a list, or a varint size
+ * and (varint key index, node) pairs for a dict. The keys are interned in the
+ * header, so keys repeated for every ad such as "convs" and "sales" cost one
+ * byte per entry, and leaves, which are mostly uniformly random XOR shares,
+ * take 8 bytes instead of up to 20 digits.
+ */
+inline constexpr std::string_view kMetricsBinaryMagic{"PCFMETR"};
+inline constexpr uint8_t kMetricsBinaryVersion = 1;
+
+enum class MetricsNodeType : uint8_t { kValue = 0, kList = 1, kDict = 2 };
+
+inline bool isMetricsBinary(std::string_view data) {
+  return data.substr(0, kMetricsBinaryMagic.size()) == kMetricsBinaryMagic;
+}
+
+/**
+ * Writes a tree node by node in depth-first order: a list or dict is begun
+ * with its size and followed by that many elements, with writeKey() before
+ * every element of a dict.
+ */
+class MetricsBinaryWriter {
+ public:
+  void writeValue(int64_t value) {
+    body_.push_back(static_cast<char>(MetricsNodeType::kValue));
+    auto bits = static_cast<uint64_t>(value);
+    for (size_t i = 0; i < sizeof(bits); ++i) {
+      body_.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+  }
+
+  void beginList(size_t size) {
+    body_.push_back(static_cast<char>(MetricsNodeType::kList));
+    writeVarint(body_, size);
+  }
+
+  void beginDict(size_t size) {
+    body_.push_back(static_cast<char>(MetricsNodeType::kDict));
+    writeVarint(body_, size);
+  }
+
+  void writeKey(const std::string& key) {
+    auto [it, inserted] = keyIndices_.emplace(key, keys_.size());
+    if (inserted) {
+      keys_.push_back(key);
+    }
+    writeVarint(body_, it->second);
+  }
+
+  // Returns the encoded tree. The writer is left empty.
+  std::string finish() {
+    std::string out{kMetricsBinaryMagic};
+    out.push_back(static_cast<char>(kMetricsBinaryVersion));
+    writeVarint(out, keys_.size());
+    for (const auto& key : keys_) {
+      writeVarint(out, key.size());
+      out.append(key);
+    }
+    out.append(body_);
+
+    body_.clear();
+    keys_.clear();
+    keyIndices_.clear();
+    return out;
+  }
+
+ private:
+  static void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  std::string body_;
+  std::vector<std::string> keys_;
+  std::unordered_map<std::string, uint64_t> keyIndices_;
+};
+
+/**
+ * Reads a tree written by MetricsBinaryWriter in the same order it was
+ * written. The data is not copied, so it has to outlive the reader. Throws
+ * std::runtime_error on malformed input.
+ */
+class MetricsBinaryReader {
+ public:
+  explicit MetricsBinaryReader(std::string_view data) : data_{data} {
+    if (!isMetricsBinary(data_)) {
+      throw std::runtime_error("Not a binary metrics file");
+    }
+    pos_ = kMetricsBinaryMagic.size();
+    auto version = static_cast<uint8_t>(readByte());
+    if (version != kMetricsBinaryVersion) {
+      throw std::runtime_error(
+          "Unsupported binary metrics version " + std::to_string(version));
+    }
+    auto numKeys = readVarint();
+    keys_.reserve(numKeys);
+    for (uint64_t i = 0; i < numKeys; ++i) {
+      auto size = readVarint();
+      keys_.emplace_back(readBytes(size));
+    }
+  }
+
+  MetricsNodeType readType() {
+    auto type = static_cast<uint8_t>(readByte());
+    if (type > static_cast<uint8_t>(MetricsNodeType::kDict)) {
+      throw std::runtime_error(
+          "Unknown binary metrics node type " + std::to_string(type));
+    }
+    return static_cast<MetricsNodeType>(type);
+  }
+
+  int64_t readValue() {
+    auto bytes = readBytes(sizeof(uint64_t));
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(bits); ++i) {
+      bits |= uint64_t{static_cast<uint8_t>(bytes[i])} << (8 * i);
+    }
+    return static_cast<int64_t>(bits);
+  }
+
+  // size of the list or dict whose type was just read
+  size_t readSize() {
+    auto size = readVarint();
+    // every element takes at least one byte
+    if (size > data_.size() - pos_) {
+      throw std::runtime_error("Truncated binary metrics");
+    }
+    return size;
+  }
+
+  const std::string& readKey() {
+    auto index = readVarint();
+    if (index >= keys_.size()) {
+      throw std::runtime_error("Binary metrics key index out of range");
+    }
+    return keys_[index];
+  }
+
+  bool done() const {
+    return pos_ == data_.size();
+  }
+
+ private:
+  char readByte() {
+    return readBytes(1)[0];
+  }
+
+  std::string_view readBytes(uint64_t size) {
+    if (size > data_.size() - pos_) {
+      throw std::runtime_error("Truncated binary metrics");
+    }
+    auto bytes = data_.substr(pos_, size);
+    pos_ += size;
+    return bytes;
+  }
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      auto byte = static_cast<uint8_t>(readByte());
+      value |= uint64_t{byte & 0x7Fu} << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw std::runtime_error("Malformed varint in binary metrics");
+  }
+
+  std::string_view data_;
+  size_t pos_ = 0;
+  std::vector<std::string> keys_;
+};
+
+// Writes obj, which may only hold objects, arrays and integers.
+inline void writeMetricsBinary(
+    MetricsBinaryWriter& writer,
+    const folly::dynamic& obj) {
+  switch (obj.type()) {
+    case folly::dynamic::INT64:
+      writer.writeValue(obj.asInt());
+      break;
+    case folly::dynamic::ARRAY:
+      writer.beginList(obj.size());
+      for (const auto& element : obj) {
+        writeMetricsBinary(writer, element);
+      }
+      break;
+    case folly::dynamic::OBJECT:
+      writer.beginDict(obj.size());
+      for (const auto& [key, element] : obj.items()) {
+        writer.writeKey(key.asString());
+        writeMetricsBinary(writer, element);
+      }
+      break;
+    default:
+      throw std::invalid_argument(
+          std::string("Cannot write ") + obj.typeName() +
+          " as binary metrics");
+  }
+}
+
+inline folly::dynamic readMetricsBinary(MetricsBinaryReader& reader) {
+  switch (reader.readType()) {
+    case MetricsNodeType::kValue:
+      return reader.readValue();
+    case MetricsNodeType::kList: {
+      auto size = reader.readSize();
+      folly::dynamic list = folly::dynamic::array();
+      for (size_t i = 0; i < size; ++i) {
+        list.push_back(readMetricsBinary(reader));
+      }
+      return list;
+    }
+    case MetricsNodeType::kDict: {
+      auto size = reader.readSize();
+      folly::dynamic dict = folly::dynamic::object();
+      for (size_t i = 0; i < size; ++i) {
+        const auto& key = reader.readKey();
+        dict.insert(key, readMetricsBinary(reader));
+      }
+      return dict;
+    }
+  }
+  throw std::runtime_error("Unknown binary metrics node type");
+}
+
+// Decodes a whole binary metrics file, e.g. to dump it as JSON for debugging.
+inline folly::dynamic metricsBinaryToDynamic(std::string_view data) {
+  MetricsBinaryReader reader{data};
+  auto obj = readMetricsBinary(reader);
+  if (!reader.done()) {
+    throw std::runtime_error("Trailing bytes after binary metrics");
+  }
+  return obj;
+}
+
+} // namespace common
@@ -7,15 +7,21 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <span>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
 
 #include "folly/dynamic.h"
 #include "folly/logging/xlog.h"
 
 #include "fbpcf/engine/communication/SocketPartyCommunicationAgent.h"
 #include "fbpcf/frontend/mpcGame.h"
+#include "fbpcs/data_processing/common/Parsing.h"
+#include "fbpcs/emp_games/common/BitMatrix.h"
 #include "fbpcs/emp_games/common/Csv.h"
 #include "fbpcs/emp_games/common/SchedulerStatistics.h"
 
@@ -23,34 +29,46 @@ namespace common {
 
 // utility method used for parsing string information to vector of type T.
 template <typename T>
-static const std::vector<T> getInnerArray(const std::string& str) {
-  // Strip the brackets [] before splitting into individual timestamp values
-  auto innerString = str;
-  innerString.erase(
-      std::remove(innerString.begin(), innerString.end(), '['),
-      innerString.end());
-  innerString.erase(
-      std::remove(innerString.begin(), innerString.end(), ']'),
-      innerString.end());
-  auto innerVals = private_measurement::csv::splitByComma(innerString, false);
-
+static std::vector<T> getInnerArray(const std::string& str) {
   std::vector<T> out;
 
-  for (const auto& innerVal : innerVals) {
-    if (!innerVal.empty()) {
-      T parsed = 0;
-      std::istringstream iss{innerVal};
-      if (std::is_unsigned<T>::value & (iss.peek() == '-')) {
-        // convert negative inputs to zero
-        iss.ignore();
-        T parsedNegative = 0;
-        iss >> parsedNegative;
-        XLOGF(ERR, "Error: input is negative {}", parsedNegative);
-      } else {
-        iss >> parsed;
-      }
-      out.push_back(parsed);
+  // Walk the comma separated values in place instead of copying and splitting
+  // the string, skipping the brackets [] around them
+  std::string_view rest{str};
+  while (!rest.empty()) {
+    auto comma = rest.find(',');
+    auto innerVal = rest.substr(0, comma);
+    rest = comma == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(comma + 1);
+    while (!innerVal.empty() &&
+           (innerVal.front() == '[' || innerVal.front() == ' ')) {
+      innerVal.remove_prefix(1);
+    }
+    while (!innerVal.empty() &&
+           (innerVal.back() == ']' || innerVal.back() == ' ')) {
+      innerVal.remove_suffix(1);
+    }
+    if (innerVal.empty()) {
+      continue;
+    }
+
+    T parsed = 0;
+    bool success;
+    if constexpr (std::is_floating_point_v<T>) {
+      double parsedDouble = 0;
+      success = private_lift::parsing::tryParseDouble(innerVal, parsedDouble);
+      parsed = static_cast<T>(parsedDouble);
+    } else if (std::is_unsigned_v<T> && innerVal.front() == '-') {
+      // convert negative inputs to zero
+      XLOGF(ERR, "Error: input is negative {}", innerVal);
+      success = true;
+    } else {
+      success = private_lift::parsing::tryParseInt(innerVal, parsed);
     }
+    if (!success) {
+      XLOGF(ERR, "Error: failed to parse {}", innerVal);
+    }
+    out.push_back(parsed);
   }
 
   return out;
@@ -58,31 +76,27 @@ static const std::vector<T> getInnerArray(const std::string& str) {
 
 /**
  * Helper method to share array, with input type T and output type O, where O
- * can be constructed from T.
+ * can be constructed from T. The output is built in place, without copying
+ * the input.
  */
 template <typename T, typename O>
-std::vector<O> privatelyShareArray(const std::vector<T>& inputArray) {
+std::vector<O> privatelyShareArray(std::span<const T> inputArray) {
   std::vector<O> outputArray;
-  for (size_t i = 0; i < inputArray.size(); ++i) {
-    outputArray.push_back(O{inputArray.at(i)});
+  outputArray.reserve(inputArray.size());
+  for (const auto& input : inputArray) {
+    outputArray.push_back(O{input});
   }
   return outputArray;
 }
 
 template <typename T, typename O>
 std::vector<std::vector<O>> privatelyShareArrays(
-    const std::vector<std::vector<T>>& inputArrays) {
+    std::span<const std::vector<T>> inputArrays) {
   std::vector<std::vector<O>> outputArrays;
-
-  for (size_t i = 0; i < inputArrays.size(); ++i) {
-    auto inputArray = inputArrays.at(i);
-    std::vector<O> outputArray;
-    for (size_t j = 0; j < inputArray.size(); ++j) {
-      outputArray.push_back(O{inputArray.at(j)});
-    }
-    outputArrays.push_back(std::move(outputArray));
+  outputArrays.reserve(inputArrays.size());
+  for (const auto& inputArray : inputArrays) {
+    outputArrays.push_back(privatelyShareArray<T, O>(inputArray));
   }
-
   return outputArrays;
 }
 
@@ -103,7 +117,8 @@ uint64_t shareIntFrom(const int myRole, uint64_t input) {
 
 /**
  * Share array of integers, with width number of bits, from sender to
- * receiver.
+ * receiver. After the size exchange, all elements are revealed together as
+ * one batch, so this takes two round trips regardless of the array size.
  */
 template <int schedulerId, size_t width, int sender, int receiver>
 std::vector<uint64_t> privatelyShareIntArrayFrom(
@@ -115,12 +130,14 @@ std::vector<uint64_t> privatelyShareIntArrayFrom(
   if (myRole == receiver) {
     inputArray.resize(arraySize);
   }
-  // Reveal to receiver
-  std::vector<uint64_t> outputArray;
-  for (auto inputVal : inputArray) {
-    outputArray.push_back(
-        shareIntFrom<schedulerId, width, sender, receiver>(myRole, inputVal));
+  if (arraySize == 0) {
+    return inputArray;
   }
+  // Reveal to receiver
+  typename fbpcf::frontend::MpcGame<
+      schedulerId>::template SecUnsignedInt<width, true>
+      secInputArray{inputArray, sender};
+  auto outputArray = secInputArray.openToParty(receiver).getValue();
   return (myRole == sender) ? inputArray : outputArray;
 }
 
@@ -128,16 +145,17 @@ template <typename T>
 std::vector<T>
 padArray(const std::vector<T>& inputArray, size_t size, T paddingValue) {
   std::vector<T> paddedInput;
-  for (size_t i = 0; i < size; ++i) {
-    if (i < inputArray.size()) {
-      paddedInput.push_back(inputArray.at(i));
-    } else {
-      paddedInput.push_back(paddingValue);
-    }
-  }
+  paddedInput.reserve(size);
+  auto end = inputArray.begin() + std::min(size, inputArray.size());
+  paddedInput.assign(inputArray.begin(), end);
+  paddedInput.resize(size, paddingValue);
   return paddedInput;
 }
 
+/**
+ * Pad every row of inputArrays to numCols entries, and add rows of
+ * paddingValue until there are numRows of them. Rows past numRows are kept.
+ */
 template <typename T>
 std::vector<std::vector<T>> padNestedArrays(
     const std::vector<std::vector<T>>& inputArrays,
@@ -145,20 +163,12 @@ std::vector<std::vector<T>> padNestedArrays(
     size_t numCols,
     T paddingValue) {
   std::vector<std::vector<T>> paddedArrays;
-  paddedArrays.reserve(numRows);
-  for (size_t i = 0; i < inputArrays.size(); ++i) {
-    std::vector<T> paddedArray(numCols);
-    for (int j = 0; j < inputArrays[i].size(); j++) {
-      paddedArray[j] = inputArrays[i][j];
-    }
-
-    for (int j = inputArrays[i].size(); j < numCols; j++) {
-      paddedArray[j] = paddingValue;
-    }
-    paddedArrays.push_back(paddedArray);
+  paddedArrays.reserve(std::max(numRows, inputArrays.size()));
+  for (const auto& inputArray : inputArrays) {
+    paddedArrays.push_back(padArray(inputArray, numCols, paddingValue));
   }
-  for (size_t i = inputArrays.size(); i < numRows; ++i) {
-    paddedArrays.push_back(std::vector<T>(numCols, paddingValue));
+  if (paddedArrays.size() < numRows) {
+    paddedArrays.resize(numRows, std::vector<T>(numCols, paddingValue));
   }
   return paddedArrays;
 }
@@ -173,14 +183,19 @@ O privatelyShareArrayWithPaddingFrom(
     const std::vector<T>& inputArray,
     size_t size,
     T paddingValue) {
-  auto paddedInput = padArray(inputArray, size, paddingValue);
-  return O{paddedInput, sender};
+  if (inputArray.size() == size) {
+    return O{inputArray, sender};
+  }
+  return O{padArray(inputArray, size, paddingValue), sender};
 }
 
 /**
  * Convert input arrays of dimension numRows by numCols to its transpose, of
  * dimension numCols by numRows. If the input has a different size, resize the
  * output accordingly and fill up additional entries with paddingValue.
+ * Bool arrays are transposed as a packed BitMatrix, other types are copied in
+ * square tiles so that both the reads and the writes stay within a few cache
+ * lines.
  **/
 template <typename T>
 std::vector<std::vector<T>> transposeArraysWithPadding(
@@ -188,37 +203,39 @@ std::vector<std::vector<T>> transposeArraysWithPadding(
     size_t numRows,
     size_t numCols,
     T paddingValue) {
-  std::vector<std::vector<T>> outputArrays;
-  for (size_t i = 0; i < numCols; ++i) {
-    std::vector<T> outputArray;
-    for (size_t j = 0; j < numRows; ++j) {
-      if (inputArrays.size() > j && inputArrays.at(j).size() > i) {
-        outputArray.push_back(inputArrays.at(j).at(i));
-      } else {
-        outputArray.push_back(paddingValue);
+  if constexpr (std::is_same_v<T, bool>) {
+    return BitMatrix::fromRows(inputArrays, numRows, numCols, paddingValue)
+        .transpose()
+        .toRows();
+  } else {
+    constexpr size_t kTileSize = 64;
+    std::vector<std::vector<T>> outputArrays(
+        numCols, std::vector<T>(numRows, paddingValue));
+    size_t availableRows = std::min(numRows, inputArrays.size());
+    for (size_t rowBegin = 0; rowBegin < availableRows;
+         rowBegin += kTileSize) {
+      size_t rowEnd = std::min(rowBegin + kTileSize, availableRows);
+      for (size_t colBegin = 0; colBegin < numCols; colBegin += kTileSize) {
+        size_t colEnd = std::min(colBegin + kTileSize, numCols);
+        for (size_t j = rowBegin; j < rowEnd; ++j) {
+          const auto& inputArray = inputArrays[j];
+          size_t end = std::min(colEnd, inputArray.size());
+          for (size_t i = colBegin; i < end; ++i) {
+            outputArrays[i][j] = inputArray[i];
+          }
+        }
       }
     }
-    outputArrays.push_back(std::move(outputArray));
+    return outputArrays;
   }
-  return outputArrays;
 }
 
 template <typename T>
 std::vector<std::vector<T>> transpose(const std::vector<std::vector<T>>& data) {
-  std::vector<std::vector<T>> result;
   if (data.size() == 0) {
-    return result;
-  }
-
-  result.reserve(data[0].size());
-  for (size_t column = 0; column < data[0].size(); column++) {
-    std::vector<T> innerArray(data.size());
-    result.push_back(std::vector<T>(data.size()));
-    for (size_t row = 0; row < data.size(); row++) {
-      result[column][row] = data[row][column];
-    }
+    return {};
   }
-  return result;
+  return transposeArraysWithPadding<T>(data, data.size(), data[0].size(), T{});
 }
 
 /**
@@ -237,7 +254,8 @@ std::vector<O> privatelyShareTransposedArraysWithPaddingFrom(
   auto transposedInputArrays = transposeArraysWithPadding<T>(
       inputArrays, numRows, numCols, paddingValue);
   std::vector<O> output;
-  for (auto& transposedInputArray : transposedInputArrays) {
+  output.reserve(transposedInputArrays.size());
+  for (const auto& transposedInputArray : transposedInputArrays) {
     output.push_back(O{transposedInputArray, sender});
   }
   return output;
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "fbpcs/emp_games/common/BitMatrix.h"
+
+/*
+ * Compares the packed bool transpose used by
+ * common::transposeArraysWithPadding with the element-wise transpose it
+ * replaced, on the shapes of the lift and attribution inputs: many rows by a
+ * few to a few hundred columns.
+ */
+
+namespace {
+
+std::vector<std::vector<bool>> randomRows(size_t numRows, size_t numCols) {
+  std::mt19937_64 gen(42);
+  std::vector<std::vector<bool>> rows(numRows, std::vector<bool>(numCols));
+  for (auto& row : rows) {
+    for (size_t col = 0; col < numCols; ++col) {
+      row[col] = gen() & 1;
+    }
+  }
+  return rows;
+}
+
+std::vector<std::vector<bool>> elementwiseTranspose(
+    const std::vector<std::vector<bool>>& inputArrays,
+    size_t numRows,
+    size_t numCols) {
+  std::vector<std::vector<bool>> outputArrays;
+  for (size_t i = 0; i < numCols; ++i) {
+    std::vector<bool> outputArray;
+    for (size_t j = 0; j < numRows; ++j) {
+      if (inputArrays.size() > j && inputArrays.at(j).size() > i) {
+        outputArray.push_back(inputArrays.at(j).at(i));
+      } else {
+        outputArray.push_back(false);
+      }
+    }
+    outputArrays.push_back(std::move(outputArray));
+  }
+  return outputArrays;
+}
+
+void elementwise(size_t iters, size_t numRows, size_t numCols) {
+  std::vector<std::vector<bool>> rows;
+  BENCHMARK_SUSPEND {
+    rows = randomRows(numRows, numCols);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(elementwiseTranspose(rows, numRows, numCols));
+  }
+}
+
+void bitMatrix(size_t iters, size_t numRows, size_t numCols) {
+  std::vector<std::vector<bool>> rows;
+  BENCHMARK_SUSPEND {
+    rows = randomRows(numRows, numCols);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(
+        common::BitMatrix::fromRows(rows, numRows, numCols)
+            .transpose()
+            .toRows());
+  }
+}
+
+} // namespace
+
+BENCHMARK_NAMED_PARAM(elementwise, 1000000x4, 1000000, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM(bitMatrix, 1000000x4, 1000000, 4)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(elementwise, 1000000x32, 1000000, 32)
+BENCHMARK_RELATIVE_NAMED_PARAM(bitMatrix, 1000000x32, 1000000, 32)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(elementwise, 100000x256, 100000, 256)
+BENCHMARK_RELATIVE_NAMED_PARAM(bitMatrix, 100000x256, 100000, 256)
+
+int main(int argc, char** argv) {
+  folly::Init init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
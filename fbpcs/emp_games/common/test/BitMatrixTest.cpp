@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "fbpcs/emp_games/common/BitMatrix.h"
+
+namespace common {
+
+std::vector<std::vector<bool>>
+randomRows(size_t numRows, size_t numCols, std::mt19937_64& gen) {
+  std::vector<std::vector<bool>> rows(numRows, std::vector<bool>(numCols));
+  for (auto& row : rows) {
+    for (size_t col = 0; col < numCols; ++col) {
+      row[col] = gen() & 1;
+    }
+  }
+  return rows;
+}
+
+TEST(BitMatrixTest, TestTransposeBlock) {
+  std::mt19937_64 gen(42);
+  std::array<uint64_t, BitMatrix::kWordBits> block;
+  for (auto& word : block) {
+    word = gen();
+  }
+  auto transposed = block;
+  BitMatrix::transposeBlock(transposed);
+  for (size_t i = 0; i < BitMatrix::kWordBits; ++i) {
+    for (size_t j = 0; j < BitMatrix::kWordBits; ++j) {
+      EXPECT_EQ((block[i] >> j) & 1, (transposed[j] >> i) & 1);
+    }
+  }
+}
+
+TEST(BitMatrixTest, TestTransposeUnalignedSizes) {
+  std::mt19937_64 gen(7);
+  for (auto [numRows, numCols] : std::vector<std::pair<size_t, size_t>>{
+           {0, 0}, {1, 1}, {3, 130}, {64, 64}, {65, 1}, {200, 77}}) {
+    auto rows = randomRows(numRows, numCols, gen);
+    auto transposed =
+        BitMatrix::fromRows(rows, numRows, numCols).transpose().toRows();
+    ASSERT_EQ(transposed.size(), numCols);
+    for (size_t col = 0; col < numCols; ++col) {
+      ASSERT_EQ(transposed[col].size(), numRows);
+      for (size_t row = 0; row < numRows; ++row) {
+        EXPECT_EQ(transposed[col][row], rows[row][col]);
+      }
+    }
+  }
+}
+
+TEST(BitMatrixTest, TestFromRowsWithPadding) {
+  std::vector<std::vector<bool>> rows{{true, false}, {}, {false, true, true}};
+  auto matrix = BitMatrix::fromRows(rows, 4, 2, true);
+  std::vector<std::vector<bool>> expected{
+      {true, false}, {true, true}, {false, true}, {true, true}};
+  EXPECT_EQ(matrix.toRows(), expected);
+
+  // Padding does not leak into the transpose beyond numCols
+  std::vector<std::vector<bool>> expectedTranspose{
+      {true, true, false, true}, {false, true, true, true}};
+  EXPECT_EQ(matrix.transpose().toRows(), expectedTranspose);
+}
+
+// Rows that end or are padded in the middle of a word
+TEST(BitMatrixTest, TestFromRowsRaggedAcrossWords) {
+  std::mt19937_64 gen(11);
+  auto rows = randomRows(5, 200, gen);
+  rows[0].resize(70);
+  rows[1].resize(0);
+  rows[2].resize(128);
+  rows[3].resize(129);
+  for (bool paddingValue : {false, true}) {
+    auto matrix = BitMatrix::fromRows(rows, 6, 130, paddingValue);
+    for (size_t row = 0; row < 6; ++row) {
+      for (size_t col = 0; col < 130; ++col) {
+        bool expected = (row < rows.size() && col < rows[row].size())
+            ? rows[row][col]
+            : paddingValue;
+        EXPECT_EQ(matrix.get(row, col), expected);
+      }
+    }
+    auto unpacked = matrix.toRows();
+    ASSERT_EQ(unpacked.size(), 6);
+    EXPECT_EQ(
+        unpacked[4],
+        std::vector<bool>(rows[4].begin(), rows[4].begin() + 130));
+  }
+}
+
+} // namespace common
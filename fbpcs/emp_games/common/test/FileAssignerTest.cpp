@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <fbpcf/engine/communication/test/AgentFactoryCreationHelper.h>
+
+#include "fbpcs/emp_games/common/Constants.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
+
+namespace common {
+
+TEST(FileAssignerTest, TestFileIndexQueue) {
+  FileIndexQueue queue(3);
+  EXPECT_EQ(queue.next(), 0);
+  EXPECT_EQ(queue.next(), 1);
+  EXPECT_EQ(queue.next(), 2);
+  EXPECT_FALSE(queue.next().has_value());
+  EXPECT_FALSE(queue.next().has_value());
+}
+
+std::vector<std::size_t> drainFileAssigner(
+    int myRole,
+    std::shared_ptr<FileIndexQueue> queue,
+    std::unique_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+        factory) {
+  FileAssigner fileAssigner(
+      myRole, queue, factory->create(1 - myRole, "file_assigner_test"));
+  std::vector<std::size_t> indices;
+  while (auto i = fileAssigner.next()) {
+    indices.push_back(*i);
+  }
+  return indices;
+}
+
+TEST(FileAssignerTest, TestPartnerFollowsPublisher) {
+  auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+
+  auto publisherFuture = std::async(
+      std::launch::async,
+      drainFileAssigner,
+      PUBLISHER,
+      std::make_shared<FileIndexQueue>(5),
+      std::move(factories[PUBLISHER]));
+  // The partner queue is never drawn from
+  auto partnerFuture = std::async(
+      std::launch::async,
+      drainFileAssigner,
+      PARTNER,
+      std::make_shared<FileIndexQueue>(0),
+      std::move(factories[PARTNER]));
+
+  std::vector<std::size_t> expected{0, 1, 2, 3, 4};
+  EXPECT_EQ(publisherFuture.get(), expected);
+  EXPECT_EQ(partnerFuture.get(), expected);
+}
+
+} // namespace common
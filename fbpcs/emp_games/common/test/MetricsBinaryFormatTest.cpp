@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+#include "fbpcs/emp_games/common/MetricsBinaryFormat.h"
+
+namespace common {
+
+folly::dynamic exampleMetrics() {
+  return folly::parseJson(R"({
+    "last_click_1d": {
+      "measurement": {
+        "1": {"convs": -831273128088263600, "sales": 339959610281870460},
+        "2": {"convs": 0, "sales": 9223372036854775807}
+      }
+    },
+    "list": [1, [], {}, [-9223372036854775807, 2]]
+  })");
+}
+
+TEST(MetricsBinaryFormatTest, TestRoundTrip) {
+  MetricsBinaryWriter writer;
+  writeMetricsBinary(writer, exampleMetrics());
+  auto binary = writer.finish();
+
+  EXPECT_TRUE(isMetricsBinary(binary));
+  EXPECT_EQ(metricsBinaryToDynamic(binary), exampleMetrics());
+  EXPECT_FALSE(isMetricsBinary(folly::toJson(exampleMetrics())));
+}
+
+TEST(MetricsBinaryFormatTest, TestKeysAreInterned) {
+  folly::dynamic perAd = folly::dynamic::object();
+  for (int64_t ad = 0; ad < 100; ++ad) {
+    perAd.insert(
+        std::to_string(ad), folly::dynamic::object("convs", ad)("sales", ad));
+  }
+
+  MetricsBinaryWriter writer;
+  writeMetricsBinary(writer, perAd);
+  auto binary = writer.finish();
+
+  // every ad adds its key index, a dict with two entries and two 9 byte
+  // leaves, but "convs" and "sales" are spelled out only once
+  EXPECT_LT(binary.size(), 100 * (2 + 2 + 2 * 11) + 400);
+  EXPECT_EQ(binary.find("convs"), binary.rfind("convs"));
+  EXPECT_EQ(metricsBinaryToDynamic(binary), perAd);
+}
+
+TEST(MetricsBinaryFormatTest, TestValueExtremes) {
+  MetricsBinaryWriter writer;
+  writer.beginList(2);
+  writer.writeValue(std::numeric_limits<int64_t>::min());
+  writer.writeValue(std::numeric_limits<int64_t>::max());
+  auto binary = writer.finish();
+
+  MetricsBinaryReader reader{binary};
+  EXPECT_EQ(reader.readType(), MetricsNodeType::kList);
+  EXPECT_EQ(reader.readSize(), 2U);
+  EXPECT_EQ(reader.readType(), MetricsNodeType::kValue);
+  EXPECT_EQ(reader.readValue(), std::numeric_limits<int64_t>::min());
+  EXPECT_EQ(reader.readType(), MetricsNodeType::kValue);
+  EXPECT_EQ(reader.readValue(), std::numeric_limits<int64_t>::max());
+  EXPECT_TRUE(reader.done());
+}
+
+TEST(MetricsBinaryFormatTest, TestMalformedInput) {
+  MetricsBinaryWriter writer;
+  writeMetricsBinary(writer, exampleMetrics());
+  auto binary = writer.finish();
+
+  EXPECT_THROW(metricsBinaryToDynamic("{}"), std::runtime_error);
+  EXPECT_THROW(
+      metricsBinaryToDynamic(binary.substr(0, binary.size() - 1)),
+      std::runtime_error);
+  EXPECT_THROW(metricsBinaryToDynamic(binary + '\0'), std::runtime_error);
+
+  auto wrongVersion = binary;
+  wrongVersion[kMetricsBinaryMagic.size()] = kMetricsBinaryVersion + 1;
+  EXPECT_THROW(metricsBinaryToDynamic(wrongVersion), std::runtime_error);
+
+  MetricsBinaryWriter stringWriter;
+  EXPECT_THROW(
+      writeMetricsBinary(stringWriter, folly::dynamic("text")),
+      std::invalid_argument);
+}
+
+} // namespace common
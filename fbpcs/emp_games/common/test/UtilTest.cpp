@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "fbpcs/emp_games/common/Util.h"
+
+namespace common {
+
+TEST(UtilTest, TestGetInnerArray) {
+  EXPECT_EQ(
+      getInnerArray<int64_t>("[1,-2, 3 ,40]"),
+      (std::vector<int64_t>{1, -2, 3, 40}));
+  EXPECT_EQ(
+      getInnerArray<uint32_t>("[0,4294967295]"),
+      (std::vector<uint32_t>{0, 4294967295}));
+  EXPECT_EQ(
+      getInnerArray<double>("[1.5,-2,3e2]"),
+      (std::vector<double>{1.5, -2, 300}));
+  EXPECT_TRUE(getInnerArray<int64_t>("[]").empty());
+}
+
+// Values that are not entirely a number are logged and stored as 0. The
+// stream based parsing used before kept the leading digits of "12abc" and
+// "10.5".
+TEST(UtilTest, TestGetInnerArrayInvalidValues) {
+  EXPECT_EQ(
+      getInnerArray<int64_t>("[12abc,10.5,7]"),
+      (std::vector<int64_t>{0, 0, 7}));
+  EXPECT_EQ(
+      getInnerArray<uint64_t>("[-5,5]"), (std::vector<uint64_t>{0, 5}));
+  EXPECT_EQ(
+      getInnerArray<uint8_t>("[256,255]"), (std::vector<uint8_t>{0, 255}));
+  EXPECT_EQ(getInnerArray<double>("[1.5x]"), (std::vector<double>{0}));
+}
+
+// Stands in for a secret type, built from the plaintext value
+struct Wrapped {
+  int64_t value;
+
+  bool operator==(const Wrapped& other) const {
+    return value == other.value;
+  }
+};
+
+TEST(UtilTest, TestPrivatelyShareArray) {
+  std::vector<int64_t> input{3, -1, 7};
+  EXPECT_EQ(
+      (privatelyShareArray<int64_t, Wrapped>(input)),
+      (std::vector<Wrapped>{{3}, {-1}, {7}}));
+  EXPECT_EQ(
+      (privatelyShareArray<int64_t, Wrapped>(
+          std::span<const int64_t>(input).subspan(1))),
+      (std::vector<Wrapped>{{-1}, {7}}));
+  EXPECT_TRUE((privatelyShareArray<int64_t, Wrapped>(
+                   std::vector<int64_t>{}))
+                  .empty());
+}
+
+TEST(UtilTest, TestPrivatelyShareArrays) {
+  std::vector<std::vector<int64_t>> input{{1, 2}, {}, {3}};
+  EXPECT_EQ(
+      (privatelyShareArrays<int64_t, Wrapped>(input)),
+      (std::vector<std::vector<Wrapped>>{{{1}, {2}}, {}, {{3}}}));
+  EXPECT_EQ(
+      (privatelyShareArrays<int64_t, Wrapped>(
+          std::span<const std::vector<int64_t>>(input).first(1))),
+      (std::vector<std::vector<Wrapped>>{{{1}, {2}}}));
+  EXPECT_TRUE((privatelyShareArrays<int64_t, Wrapped>(
+                   std::vector<std::vector<int64_t>>{}))
+                  .empty());
+}
+
+TEST(UtilTest, TestPadArray) {
+  std::vector<int64_t> input{1, 2, 3};
+  EXPECT_EQ(
+      padArray<int64_t>(input, 5, -1),
+      (std::vector<int64_t>{1, 2, 3, -1, -1}));
+  EXPECT_EQ(padArray<int64_t>(input, 3, -1), input);
+  EXPECT_EQ(padArray<int64_t>(input, 2, -1), (std::vector<int64_t>{1, 2}));
+  EXPECT_TRUE(padArray<int64_t>(input, 0, -1).empty());
+  EXPECT_EQ(padArray<int64_t>({}, 2, -1), (std::vector<int64_t>{-1, -1}));
+}
+
+TEST(UtilTest, TestPadNestedArrays) {
+  std::vector<std::vector<int64_t>> input{{1}, {2, 3, 4}, {}};
+
+  // missing rows and columns are padded, longer rows are cut to numCols
+  EXPECT_EQ(
+      padNestedArrays<int64_t>(input, 4, 2, 0),
+      (std::vector<std::vector<int64_t>>{{1, 0}, {2, 3}, {0, 0}, {0, 0}}));
+
+  // rows past numRows are kept
+  EXPECT_EQ(
+      padNestedArrays<int64_t>(input, 2, 3, 9),
+      (std::vector<std::vector<int64_t>>{{1, 9, 9}, {2, 3, 4}, {9, 9, 9}}));
+
+  EXPECT_EQ(
+      padNestedArrays<int64_t>({}, 2, 1, 5),
+      (std::vector<std::vector<int64_t>>{{5}, {5}}));
+  EXPECT_EQ(
+      padNestedArrays<int64_t>(input, 3, 0, 5),
+      (std::vector<std::vector<int64_t>>{{}, {}, {}}));
+  EXPECT_TRUE(padNestedArrays<int64_t>({}, 0, 3, 5).empty());
+}
+
+} // namespace common
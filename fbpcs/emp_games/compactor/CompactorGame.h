@@ -43,8 +43,12 @@ class BaseCompactorGame : public fbpcf::frontend::MpcGame<schedulerId> {
       const SecretAttributionOutput<schedulerId>& secret,
       uint32_t size,
       bool shouldRevealSize) {
-    auto compactor = getCompactor(myId_, partnerId_);
-    auto [rstMetadata, rstLabel] = compactor->compaction(
+    // The compactor chain (shuffler, permuter and PRG factory) only depends on
+    // the parties, so it is built on the first play and reused afterwards.
+    if (compactor_ == nullptr) {
+      compactor_ = getCompactor(myId_, partnerId_);
+    }
+    auto [rstMetadata, rstLabel] = compactor_->compaction(
         {secret.adId, secret.conversionValue},
         secret.isAttributed,
         size,
@@ -63,6 +67,10 @@ class BaseCompactorGame : public fbpcf::frontend::MpcGame<schedulerId> {
   getCompactor(int myId, int partnerId) = 0;
   int myId_;
   int partnerId_;
+  std::unique_ptr<fbpcf::mpc_std_lib::compactor::ICompactor<
+      typename fbpcf::mpc_std_lib::util::SecBatchType<T, schedulerId>::type,
+      typename fbpcf::mpc_std_lib::util::SecBatchType<bool, schedulerId>::type>>
+      compactor_;
 };
 
 template <typename T, int schedulerId>
@@ -118,12 +118,12 @@ class DotproductApp {
           auto [features, labels] =
               parseLine(lineNo, header, parts, labelWidth, numFeatures);
           if (features.size() != 0)
-            allFeatures.push_back(features);
-          allLabels.push_back(labels);
+            allFeatures.push_back(std::move(features));
+          allLabels.push_back(std::move(labels));
           lineNo++;
         });
 
-    return {allFeatures, transposeLabels(allLabels, labelWidth)};
+    return {std::move(allFeatures), transposeLabels(allLabels, labelWidth)};
   }
 
   static std::tuple<std::vector<double>, std::vector<bool>> parseLine(
@@ -153,11 +153,11 @@ class DotproductApp {
         }
       }
     }
-    return {features, labels};
+    return {std::move(features), std::move(labels)};
   }
 
   static inline std::vector<std::vector<bool>> transposeLabels(
-      std::vector<std::vector<bool>> labels,
+      const std::vector<std::vector<bool>>& labels,
       int labelWidth) {
     std::vector<std::vector<bool>> transposedLabels(
         labelWidth, std::vector<bool>(labels.size()));
@@ -10,6 +10,7 @@
 #include "folly/logging/xlog.h"
 
 #include "fbpcf/frontend/mpcGame.h"
+#include "fbpcf/mpc_std_lib/walr_multiplication/IWalrMatrixMultiplication.h"
 #include "fbpcs/emp_games/common/Debug.h"
 #include "fbpcs/emp_games/common/Util.h"
 #include "fbpcs/emp_games/dotproduct/DotproductOptions.h"
@@ -27,17 +28,34 @@ class DotproductGame : public fbpcf::frontend::MpcGame<schedulerId> {
       : fbpcf::frontend::MpcGame<schedulerId>(std::move(scheduler)),
         communicationAgentFactory_(communicationAgentFactory) {}
 
+  // The input is borrowed, so the feature matrix is never copied
   std::vector<double> computeDotProduct(
       const int myRole,
       const std::tuple<
           std::vector<std::vector<double>>,
-          std::vector<std::vector<bool>>> inputTuple,
+          std::vector<std::vector<bool>>>& inputTuple,
       size_t nLabels,
       size_t nFeatures,
       double delta,
       double eps,
       const bool addDpNoise);
 
+  /*
+   * Evaluate several label sets against the same features with the same peer.
+   * The OT extension (base OTs and the RCOT extender) is bootstrapped once and
+   * reused by every query. Returns one dot product per label set for the
+   * publisher and empty results for the partner. The partner adds fresh DP
+   * noise to each query.
+   */
+  std::vector<std::vector<double>> computeDotProducts(
+      const int myRole,
+      const std::vector<std::vector<double>>& features,
+      const std::vector<std::vector<std::vector<bool>>>& labelSets,
+      size_t nFeatures,
+      double delta,
+      double eps,
+      const bool addDpNoise);
+
   virtual std::vector<double>
   generateDpNoise(int nFeatures, double delta, double eps, bool addDpNoise);
 
@@ -51,6 +69,21 @@ class DotproductGame : public fbpcf::frontend::MpcGame<schedulerId> {
       const std::vector<fbpcf::frontend::Bit<true, schedulerId, true>>& labels);
 
   virtual ~DotproductGame<schedulerId>() = default;
+
+ private:
+  std::unique_ptr<
+      fbpcf::mpc_std_lib::walr::IWalrMatrixMultiplication<schedulerId>>
+  createMatrixMultiplication(const int myRole);
+
+  std::vector<double> computeQuery(
+      fbpcf::mpc_std_lib::walr::IWalrMatrixMultiplication<schedulerId>& matMul,
+      const int myRole,
+      const std::vector<std::vector<double>>& features,
+      const std::vector<std::vector<bool>>& labels,
+      size_t nFeatures,
+      double delta,
+      double eps,
+      const bool addDpNoise);
 };
 
 } // namespace pcf2_dotproduct
@@ -35,15 +35,66 @@ std::vector<double> DotproductGame<schedulerId>::computeDotProduct(
     const int myRole,
     const std::tuple<
         std::vector<std::vector<double>>,
-        std::vector<std::vector<bool>>> inputTuple,
+        std::vector<std::vector<bool>>>& inputTuple,
     size_t nLabels,
     size_t nFeatures,
     double delta,
     double eps,
     const bool addDpNoise) {
-  // Plaintext label secret share
-  std::vector<std::vector<bool>> labels = std::get<1>(inputTuple);
+  auto matMul = createMatrixMultiplication(myRole);
+  XLOG(INFO, "Created Matrix Multiplication");
+
+  return computeQuery(
+      *matMul,
+      myRole,
+      std::get<0>(inputTuple),
+      std::get<1>(inputTuple),
+      nFeatures,
+      delta,
+      eps,
+      addDpNoise);
+}
+
+template <int schedulerId>
+std::vector<std::vector<double>>
+DotproductGame<schedulerId>::computeDotProducts(
+    const int myRole,
+    const std::vector<std::vector<double>>& features,
+    const std::vector<std::vector<std::vector<bool>>>& labelSets,
+    size_t nFeatures,
+    double delta,
+    double eps,
+    const bool addDpNoise) {
+  auto matMul = createMatrixMultiplication(myRole);
+  XLOG(INFO, "Created Matrix Multiplication");
+
+  std::vector<std::vector<double>> results;
+  results.reserve(labelSets.size());
+  for (size_t i = 0; i < labelSets.size(); ++i) {
+    XLOGF(INFO, "Computing query {}", i);
+    results.push_back(computeQuery(
+        *matMul,
+        myRole,
+        features,
+        labelSets.at(i),
+        nFeatures,
+        delta,
+        eps,
+        addDpNoise));
+  }
+  return results;
+}
 
+template <int schedulerId>
+std::vector<double> DotproductGame<schedulerId>::computeQuery(
+    fbpcf::mpc_std_lib::walr::IWalrMatrixMultiplication<schedulerId>& matMul,
+    const int myRole,
+    const std::vector<std::vector<double>>& features,
+    const std::vector<std::vector<bool>>& labels,
+    size_t nFeatures,
+    double delta,
+    double eps,
+    const bool addDpNoise) {
   // Create label secret shares
   auto labelShare = createSecretLabelShare(labels);
   XLOG(INFO, "Created Label secret shares");
@@ -52,8 +103,23 @@ std::vector<double> DotproductGame<schedulerId>::computeDotProduct(
   auto finalLabel = orAllLabels(labelShare);
   XLOG(INFO, "Performed the OR for all labels");
 
+  std::vector<double> rst;
+  if (myRole == common::PUBLISHER) {
+    rst = matMul.matrixVectorMultiplication(features, finalLabel);
+  } else if (myRole == common::PARTNER) {
+    // Create noise vector
+    const std::vector<double> dpNoise =
+        generateDpNoise(nFeatures, delta, eps, addDpNoise);
+    matMul.matrixVectorMultiplication(finalLabel, dpNoise);
+  }
+  return rst;
+}
+
+template <int schedulerId>
+std::unique_ptr<
+    fbpcf::mpc_std_lib::walr::IWalrMatrixMultiplication<schedulerId>>
+DotproductGame<schedulerId>::createMatrixMultiplication(const int myRole) {
   constexpr uint64_t divisor = static_cast<uint64_t>(1e9);
-  constexpr double tolerance = 1e-7;
 
   auto prgFactory = std::make_unique<fbpcf::engine::util::AesPrgFactory>();
 
@@ -80,50 +146,19 @@ std::vector<double> DotproductGame<schedulerId>::computeDotProduct(
       fbpcf::mpc_std_lib::walr::util::COTWithRandomMessageFactory>(
       std::move(rcotFactory));
 
-  std::vector<double> rst;
-  if (myRole == common::PUBLISHER) {
-    // Read features
-    std::vector<std::vector<double>> features = std::get<0>(inputTuple);
-
-    // Create matrix multiplication factory
-    auto matMulFactoryPublisher = std::make_unique<
-        fbpcf::mpc_std_lib::walr::
-            OTBasedMatrixMultiplicationFactory<schedulerId, uint64_t>>(
-        myRole,
-        1 - myRole,
-        true,
-        divisor,
-        *communicationAgentFactory_,
-        std::move(prgFactory),
-        std::move(cotWRMFactory));
-
-    XLOG(INFO, "Created Matrix Multiplication Factory");
-
-    rst = matMulFactoryPublisher->create()->matrixVectorMultiplication(
-        features, finalLabel);
-
-  } else if (myRole == common::PARTNER) {
-    // Create noise vector
-    const std::vector<double> dpNoise =
-        generateDpNoise(nFeatures, delta, eps, addDpNoise);
-
-    // Create matrix multiplication factory
-    auto matMulFactoryPartner = std::make_unique<
-        fbpcf::mpc_std_lib::walr::
-            OTBasedMatrixMultiplicationFactory<schedulerId, uint64_t>>(
-        myRole,
-        1 - myRole,
-        false,
-        divisor,
-        *communicationAgentFactory_,
-        std::move(prgFactory),
-        std::move(cotWRMFactory));
-    XLOG(INFO, "Created Matrix Multiplication Factory");
-
-    matMulFactoryPartner->create()->matrixVectorMultiplication(
-        finalLabel, dpNoise);
-  }
-  return rst;
+  // The publisher holds the features
+  auto matMulFactory = std::make_unique<
+      fbpcf::mpc_std_lib::walr::
+          OTBasedMatrixMultiplicationFactory<schedulerId, uint64_t>>(
+      myRole,
+      1 - myRole,
+      myRole == common::PUBLISHER,
+      divisor,
+      *communicationAgentFactory_,
+      std::move(prgFactory),
+      std::move(cotWRMFactory));
+
+  return matMulFactory->create();
 }
 
 template <int schedulerId>
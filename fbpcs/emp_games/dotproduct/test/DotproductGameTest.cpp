@@ -100,6 +100,35 @@ std::vector<double> runGame(
   return output;
 }
 
+template <int PARTY, int schedulerId>
+std::vector<std::vector<double>> runMultiQueryGame(
+    std::unique_ptr<
+        fbpcf::engine::communication::IPartyCommunicationAgentFactory> factory,
+    fbpcf::SchedulerCreator schedulerCreator,
+    std::vector<std::string> inputFilePaths,
+    int numFeatures,
+    int labelWidth) {
+  auto scheduler = schedulerCreator(PARTY, *factory);
+
+  DotproductGame<schedulerId> game(std::move(scheduler), std::move(factory));
+
+  // All queries share the features of the first input file
+  std::vector<std::vector<double>> features;
+  std::vector<std::vector<std::vector<bool>>> labelSets;
+  for (const auto& inputFilePath : inputFilePaths) {
+    auto [queryFeatures, labels] =
+        DotproductApp<PARTY, schedulerId>::readCSVInput(
+            inputFilePath, labelWidth, numFeatures);
+    if (labelSets.empty()) {
+      features = std::move(queryFeatures);
+    }
+    labelSets.push_back(std::move(labels));
+  }
+
+  return game.computeDotProducts(
+      PARTY, features, labelSets, numFeatures, 1e-6, 5, false);
+}
+
 std::vector<std::vector<bool>> getBooleanLabels(
     std::vector<std::string> labelStringVec,
     int labelWidth) {
@@ -258,6 +287,57 @@ void testDotproductGame(fbpcf::SchedulerType schedulerType, bool addDpNoise) {
   EXPECT_TRUE(equal);
 }
 
+void testMultiQueryDotproductGame(fbpcf::SchedulerType schedulerType) {
+  auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+  const bool unsafe = true;
+  fbpcf::SchedulerCreator schedulerCreator =
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType);
+
+  std::string baseDir =
+      private_measurement::test_util::getBaseDirFromPath(__FILE__);
+  const int numQueries = 2;
+  const int NUM_FEATURES = 50;
+  const int LABEL_WIDTH = 16;
+
+  // Both test inputs have the same features with different labels
+  std::vector<std::string> filenames0;
+  std::vector<std::string> filenames1;
+  std::vector<std::string> expectedOutputs;
+  for (int i = 0; i < numQueries; ++i) {
+    filenames0.push_back(folly::sformat(
+        "{}/test_correctness/publisher_dotprodtest_{}.csv", baseDir, i));
+    filenames1.push_back(folly::sformat(
+        "{}/test_correctness/partner_dotprodtest_{}.csv", baseDir, i));
+    expectedOutputs.push_back(folly::sformat(
+        "{}/test_correctness/expected_result_{}.csv", baseDir, i));
+  }
+
+  auto futureAlice = std::async(
+      runMultiQueryGame<0, 0>,
+      std::move(factories[0]),
+      schedulerCreator,
+      filenames0,
+      NUM_FEATURES,
+      LABEL_WIDTH);
+  auto futureBob = std::async(
+      runMultiQueryGame<1, 1>,
+      std::move(factories[1]),
+      schedulerCreator,
+      filenames1,
+      NUM_FEATURES,
+      LABEL_WIDTH);
+
+  auto outputs = futureAlice.get();
+  futureBob.get();
+
+  ASSERT_EQ(outputs.size(), numQueries);
+  for (int i = 0; i < numQueries; ++i) {
+    auto expectedResult = parseResult(expectedOutputs.at(i));
+    EXPECT_EQ(outputs.at(i).size(), expectedResult.size());
+    EXPECT_TRUE(verifyOutput(outputs.at(i), expectedResult));
+  }
+}
+
 /* run the same tests with multiple schedulers */
 class DotproductGameTestFixture
     : public ::testing::TestWithParam<fbpcf::SchedulerType> {};
@@ -278,6 +358,10 @@ TEST_P(DotproductGameTestFixture, TestDotProductGameWithNoise) {
   // No Dp noise
   testDotproductGame(schedulerType, false);
 }
+TEST_P(DotproductGameTestFixture, TestMultiQueryDotProductGame) {
+  auto schedulerType = GetParam();
+  testMultiQueryDotproductGame(schedulerType);
+}
 
 INSTANTIATE_TEST_SUITE_P(
     DotproductGameTest,
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include "fbpcf/engine/util/AesPrgFactory.h"
 #include "fbpcf/mpc_std_lib/unified_data_process/adapter/AdapterFactory.h"
 #include "fbpcf/mpc_std_lib/unified_data_process/data_processor/DataProcessorFactory.h"
 #include "fbpcs/emp_games/lift/metadata_compaction/IMetadataCompactorGame.h"
@@ -14,6 +17,11 @@
 
 namespace private_lift {
 
+/**
+ * The adapter, data processor and PRG factory are built once per game, i.e.
+ * once per scheduler, and reused for every shard played on it. Only the PRG
+ * seed used to shuffle the union map is refreshed on each play.
+ */
 template <int schedulerId>
 class MetadataCompactorGame : public IMetadataCompactorGame<schedulerId>,
                               public fbpcf::frontend::MpcGame<schedulerId> {
@@ -25,29 +33,30 @@ class MetadataCompactorGame : public IMetadataCompactorGame<schedulerId>,
           agentFactory)
       : fbpcf::frontend::MpcGame<schedulerId>(std::move(scheduler)),
         party_{party},
-        agentFactory_{agentFactory} {}
+        agentFactory_{agentFactory},
+        prgFactory_{std::make_unique<fbpcf::engine::util::AesPrgFactory>()} {
+    int partnerParty =
+        party_ == common::PUBLISHER ? common::PARTNER : common::PUBLISHER;
+    adapter_ = fbpcf::mpc_std_lib::unified_data_process::adapter::
+                   getAdapterFactoryWithAsWaksmanBasedShuffler<schedulerId>(
+                       party_ == common::PUBLISHER, party_, partnerParty)
+                       ->create();
+    dataProcessor_ = fbpcf::mpc_std_lib::unified_data_process::data_processor::
+                         getDataProcessorFactoryWithAesCtr<schedulerId>(
+                             party_, partnerParty, agentFactory_)
+                             ->create();
+  }
 
   std::unique_ptr<IInputProcessor<schedulerId>> play(
       InputData inputData,
       int32_t numConversionPerUser) override {
-    int partnerParty =
-        party_ == common::PUBLISHER ? common::PARTNER : common::PUBLISHER;
-    auto adapter = fbpcf::mpc_std_lib::unified_data_process::adapter::
-                       getAdapterFactoryWithAsWaksmanBasedShuffler<schedulerId>(
-                           party_ == common::PUBLISHER, party_, partnerParty)
-                           ->create();
-    auto dataProcessor =
-        fbpcf::mpc_std_lib::unified_data_process::data_processor::
-            getDataProcessorFactoryWithAesCtr<schedulerId>(
-                party_, partnerParty, agentFactory_)
-                ->create();
-    auto prg = std::make_unique<fbpcf::engine::util::AesPrgFactory>()->create(
-        fbpcf::engine::util::getRandomM128iFromSystemNoise());
+    auto prg =
+        prgFactory_->create(fbpcf::engine::util::getRandomM128iFromSystemNoise());
 
     return std::make_unique<CompactionBasedInputProcessor<schedulerId>>(
         party_,
-        std::move(adapter),
-        std::move(dataProcessor),
+        adapter_,
+        dataProcessor_,
         std::move(prg),
         inputData,
         numConversionPerUser);
@@ -56,6 +65,12 @@ class MetadataCompactorGame : public IMetadataCompactorGame<schedulerId>,
  private:
   const int party_;
   fbpcf::engine::communication::IPartyCommunicationAgentFactory& agentFactory_;
+  std::unique_ptr<fbpcf::engine::util::IPrgFactory> prgFactory_;
+  std::shared_ptr<fbpcf::mpc_std_lib::unified_data_process::adapter::IAdapter>
+      adapter_;
+  std::shared_ptr<fbpcf::mpc_std_lib::unified_data_process::data_processor::
+                      IDataProcessor<schedulerId>>
+      dataProcessor_;
 };
 
 } // namespace private_lift
@@ -53,6 +53,7 @@ class Aggregator {
     sumEvents();
     sumConverters();
     sumNumConvSquared();
+    sumConvHistogram();
     sumMatch();
     sumReachedConversions();
     sumValues();
@@ -85,6 +86,8 @@ class Aggregator {
 
   void sumNumConvSquared();
 
+  void sumConvHistogram();
+
   void sumMatch();
 
   void sumReachedConversions();
@@ -225,6 +225,50 @@ void Aggregator<schedulerId>::sumNumConvSquared() {
   }
 }
 
+template <int schedulerId>
+void Aggregator<schedulerId>::sumConvHistogram() {
+  XLOG(INFO) << "Aggregate conversion histogram";
+  // Each bin is aggregated separately across test/control and cohorts. This
+  // is a no-op if the attributor did not compute a histogram.
+  for (const auto& bin : attributor_->getConvHistogram()) {
+    std::vector<std::vector<bool>> valueShares(
+        valueWidth,
+        std::vector<bool>(
+            inputProcessor_->getLiftGameProcessedData().numRows, 0));
+    valueShares[0] = bin.extractBit().getValue();
+    auto oram = unsignedWriteOnlyOramFactory_->create(
+        inputProcessor_->getLiftGameProcessedData().numGroups);
+    auto aggregationOutput = aggregate<false, valueWidth, false>(
+        inputProcessor_->getLiftGameProcessedData().indexShares,
+        valueShares,
+        inputProcessor_->getLiftGameProcessedData().numGroups,
+        std::move(oram));
+
+    // Extract metrics
+    auto populationOutput = revealPopulationOutput(aggregationOutput, false);
+    metrics_.testConvHistogram.push_back(std::get<0>(populationOutput));
+    metrics_.controlConvHistogram.push_back(std::get<1>(populationOutput));
+    auto cohortOutput = revealCohortOutput(aggregationOutput, false);
+    for (size_t i = 0;
+         i < inputProcessor_->getLiftGameProcessedData().numPartnerCohorts;
+         ++i) {
+      cohortMetrics_[i].testConvHistogram.push_back(
+          std::get<0>(cohortOutput).at(i));
+      cohortMetrics_[i].controlConvHistogram.push_back(
+          std::get<1>(cohortOutput).at(i));
+    }
+    auto breakdownOutput = revealBreakdownOutput(aggregationOutput, false);
+    for (size_t i = 0;
+         i < inputProcessor_->getLiftGameProcessedData().numPublisherBreakdowns;
+         ++i) {
+      publisherBreakdowns_[i].testConvHistogram.push_back(
+          std::get<0>(breakdownOutput).at(i));
+      publisherBreakdowns_[i].controlConvHistogram.push_back(
+          std::get<1>(breakdownOutput).at(i));
+    }
+  }
+}
+
 template <int schedulerId>
 void Aggregator<schedulerId>::sumMatch() {
   XLOG(INFO) << "Aggregate matchCount";
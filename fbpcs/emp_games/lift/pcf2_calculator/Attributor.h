@@ -19,10 +19,14 @@ class Attributor {
  public:
   Attributor(
       int myRole,
-      std::unique_ptr<IInputProcessor<schedulerId>> inputProcessor)
+      std::unique_ptr<IInputProcessor<schedulerId>> inputProcessor,
+      bool computeConvHistogram = false)
       : myRole_{myRole}, inputProcessor_{std::move(inputProcessor)} {
     calculateEvents();
     calculateNumConvSquaredAndValueSquaredAndConverters();
+    if (computeConvHistogram) {
+      calculateConvHistogram();
+    }
     calculateMatch();
     calculateReachedConversions();
     calculateValues();
@@ -40,6 +44,10 @@ class Attributor {
     return numConvSquared_;
   }
 
+  const std::vector<SecBit<schedulerId>> getConvHistogram() const {
+    return convHistogram_;
+  }
+
   const SecBit<schedulerId> getMatch() const {
     return match_;
   }
@@ -69,6 +77,11 @@ class Attributor {
   // Test/Control value squared: sum(valid event ? purchaseValue : 0)^2
   void calculateNumConvSquaredAndValueSquaredAndConverters();
 
+  // Test/Control conversion histogram: convHistogram[k] is set for rows with
+  // a valid opportunity and exactly k valid events. Left empty unless
+  // computeConvHistogram is set.
+  void calculateConvHistogram();
+
   // Test/control match: valid opportunity timestamp & any valid purchase
   // timestamp
   void calculateMatch();
@@ -84,8 +97,11 @@ class Attributor {
   std::unique_ptr<IInputProcessor<schedulerId>> inputProcessor_;
 
   std::vector<SecBit<schedulerId>> events_;
+  // firstValidEvents_[i] is set if events_[i] is the first valid event
+  std::vector<SecBit<schedulerId>> firstValidEvents_;
   SecBit<schedulerId> converters_;
   SecNumConvSquared<schedulerId> numConvSquared_;
+  std::vector<SecBit<schedulerId>> convHistogram_;
   SecBit<schedulerId> match_;
   std::vector<SecBit<schedulerId>> reachedConversions_;
   std::vector<SecValue<schedulerId>> values_;
@@ -30,89 +30,87 @@ template <int schedulerId>
 void Attributor<
     schedulerId>::calculateNumConvSquaredAndValueSquaredAndConverters() {
   XLOG(INFO) << "Calculate numConvSquared & valueSquared & converters";
-  if (events_.size() !=
-      inputProcessor_->getLiftGameProcessedData().purchaseValueSquared.size()) {
+  const auto& purchaseValueSquared =
+      inputProcessor_->getLiftGameProcessedData().purchaseValueSquared;
+  auto numRows = inputProcessor_->getLiftGameProcessedData().numRows;
+  if (events_.size() != purchaseValueSquared.size()) {
     XLOG(FATAL)
         << "Numbers of event bits and purchase values squared are inconsistent.";
   }
-  // We find the first valid event using a binary tree approach. The number of
-  // conversions is the remaining number of elements in the array. The value
-  // squared is the squared sum of the values for valid events in each row.
-  // These sums are already precomputed, so it suffices to check for the first
-  // valid event and use the sum corresponding to the position in the row.
+  // The number of conversions is the number of events from the first valid
+  // event on, and the value squared sums are precomputed per position, so both
+  // only depend on the position of the first valid event. We find it with a
+  // prefix OR over the events, which gives a one-hot vector of first valid
+  // events, and then select the candidates with it.
 
-  // We first construct new arrays to store the intermediate results
-  std::vector<SecNumConvSquared<schedulerId>> numConvSquaredArray;
-  for (size_t i = 0; i < events_.size(); ++i) {
-    auto numConv = events_.size() - i;
-    auto convSquared = static_cast<uint32_t>(numConv * numConv);
-    SecNumConvSquared<schedulerId> numConvSquared(
-        std::vector(
-            inputProcessor_->getLiftGameProcessedData().numRows, convSquared),
-        common::PUBLISHER);
-    numConvSquaredArray.push_back(numConvSquared);
+  // Inclusive prefix OR in log depth: after the pass with distance d,
+  // anyValidEventUpTo[i] covers events (i - 2d, i].
+  std::vector<SecBit<schedulerId>> anyValidEventUpTo = events_;
+  for (size_t d = 1; d < events_.size(); d <<= 1) {
+    for (size_t i = events_.size() - 1; i >= d; --i) {
+      anyValidEventUpTo[i] = anyValidEventUpTo[i] | anyValidEventUpTo[i - d];
+    }
   }
-  // The numConvSquared is zero if there are no valid events
-  SecNumConvSquared<schedulerId> zero{
-      std::vector<uint32_t>(
-          inputProcessor_->getLiftGameProcessedData().numRows, 0),
-      common::PUBLISHER};
-  numConvSquaredArray.push_back(zero);
 
-  std::vector<SecValueSquared<schedulerId>> valueSquaredArray =
-      inputProcessor_->getLiftGameProcessedData().purchaseValueSquared;
-  // The value squared is zero if there are no valid events
-  SecValueSquared<schedulerId> zeroValueSquared{
-      std::vector<int64_t>(
-          inputProcessor_->getLiftGameProcessedData().numRows, 0),
-      common::PUBLISHER};
-  valueSquaredArray.push_back(zeroValueSquared);
+  firstValidEvents_.clear();
+  firstValidEvents_.reserve(events_.size());
+  for (size_t i = 0; i < events_.size(); ++i) {
+    firstValidEvents_.push_back(
+        i == 0 ? events_.at(0)
+               : events_.at(i) & !anyValidEventUpTo.at(i - 1));
+  }
 
-  std::vector<SecBit<schedulerId>> eventArray = events_;
-  SecBit<schedulerId> zeroBit{
-      std::vector<bool>(
-          inputProcessor_->getLiftGameProcessedData().numRows, false),
-      common::PUBLISHER};
-  eventArray.push_back(zeroBit);
+  // A converter occurs when a row contains any valid event
+  converters_ = events_.empty() ? SecBit<schedulerId>{std::vector<bool>(
+                                       numRows, false),
+                                   common::PUBLISHER}
+                               : anyValidEventUpTo.back();
 
-  int stepSize = 1; // we process the array elements in pairs with indices
-                    // differing by stepSize
-  auto firstIndex = 0ULL; // first index at this level
-  while (firstIndex < eventArray.size() / 2) {
-    for (size_t i = firstIndex; i < eventArray.size(); i += 2 * stepSize) {
-      if (i + stepSize < eventArray.size()) {
-        // If there is a valid event at i, we set the numConvSquared to be
-        // numConvSquared[i], else we set it to be numConvSquared[i + stepSize]
-        numConvSquaredArray[i + stepSize] =
-            numConvSquaredArray.at(i + stepSize)
-                .mux(eventArray.at(i), numConvSquaredArray.at(i));
-        // The same logic applies for the valueSquared
-        valueSquaredArray[i + stepSize] =
-            valueSquaredArray.at(i + stepSize)
-                .mux(eventArray.at(i), valueSquaredArray.at(i));
-        // Update the events for the next level
-        eventArray[i + stepSize] =
-            eventArray.at(i + stepSize) | eventArray.at(i);
-      } else {
-        // Odd number of elements at this level, compute the mux with the
-        // previous pair
-        auto previousIndex = i - stepSize;
-        numConvSquaredArray[previousIndex] = numConvSquaredArray.at(i).mux(
-            eventArray.at(previousIndex),
-            numConvSquaredArray.at(previousIndex));
-        valueSquaredArray[previousIndex] = valueSquaredArray.at(i).mux(
-            eventArray.at(previousIndex), valueSquaredArray.at(previousIndex));
-        eventArray[previousIndex] =
-            eventArray.at(previousIndex) | eventArray.at(i);
+  // At most one first valid event is set per row, so the selected candidate
+  // is the XOR of all candidates masked with their first valid event bit.
+  // XOR is linear in the secret shares, so we combine the shares locally: the
+  // public numConvSquared candidates need no AND gates at all, and each secret
+  // valueSquared candidate needs a single mux with zero.
+  std::vector<uint64_t> numConvSquaredShares(numRows, 0);
+  std::vector<int64_t> valueSquaredShares(numRows, 0);
+  PubValueSquared<schedulerId> zero{std::vector<int64_t>(numRows, 0)};
+  for (size_t i = 0; i < events_.size(); ++i) {
+    auto numConv = events_.size() - i;
+    auto convSquared = static_cast<uint64_t>(numConv * numConv);
+    auto firstValidEventShares =
+        firstValidEvents_.at(i).extractBit().getValue();
+    auto maskedValueSquaredShares =
+        zero.mux(firstValidEvents_.at(i), purchaseValueSquared.at(i))
+            .extractIntShare()
+            .getValue();
+    for (size_t row = 0; row < numRows; ++row) {
+      if (firstValidEventShares[row]) {
+        numConvSquaredShares[row] ^= convSquared;
       }
+      valueSquaredShares[row] ^= maskedValueSquaredShares[row];
     }
-    firstIndex += stepSize;
-    stepSize = stepSize << 1;
   }
-  valueSquared_ = valueSquaredArray.at(firstIndex);
-  numConvSquared_ = numConvSquaredArray.at(firstIndex);
-  // A converter occurs when a row contains any valid event
-  converters_ = eventArray.at(firstIndex);
+  numConvSquared_ = SecNumConvSquared<schedulerId>(
+      typename SecNumConvSquared<schedulerId>::ExtractedInt(
+          numConvSquaredShares));
+  valueSquared_ = SecValueSquared<schedulerId>(
+      typename SecValueSquared<schedulerId>::ExtractedInt(valueSquaredShares));
+}
+
+template <int schedulerId>
+void Attributor<schedulerId>::calculateConvHistogram() {
+  XLOG(INFO) << "Calculate conversion histogram";
+  // A row with its first valid event at index i has events_.size() - i valid
+  // events, so it falls into that bin.
+  convHistogram_.resize(events_.size() + 1);
+  for (size_t i = 0; i < events_.size(); ++i) {
+    convHistogram_[events_.size() - i] = firstValidEvents_.at(i);
+  }
+  // Rows outside of the test/control population are aggregated into the test
+  // groups, so the zero bin only counts rows with a valid opportunity.
+  convHistogram_[0] =
+      inputProcessor_->getLiftGameProcessedData().isValidOpportunityTimestamp &
+      !converters_;
 }
 
 template <int schedulerId>
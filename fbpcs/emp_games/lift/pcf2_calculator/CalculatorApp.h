@@ -14,6 +14,7 @@
 
 #include "fbpcf/engine/communication/IPartyCommunicationAgentFactory.h"
 #include "fbpcf/scheduler/SchedulerHelper.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/common/SchedulerStatistics.h"
 #include "fbpcs/emp_games/lift/pcf2_calculator/CalculatorGame.h"
 #include "fbpcs/emp_games/lift/pcf2_calculator/CalculatorGameConfig.h"
@@ -39,7 +40,9 @@ class CalculatorApp {
       std::shared_ptr<fbpcf::util::MetricCollector> metricCollector,
       const int startFileIndex = 0,
       const int numFiles = 1,
-      const bool useXorEncryption = true)
+      const bool useXorEncryption = true,
+      std::shared_ptr<common::FileIndexQueue> fileIndexQueue = nullptr,
+      const bool computeConvHistogram = false)
       : party_{party},
         communicationAgentFactory_{std::move(communicationAgentFactory)},
         numConversionsPerUser_(numConversionsPerUser),
@@ -52,7 +55,9 @@ class CalculatorApp {
         metricCollector_(metricCollector),
         startFileIndex_(startFileIndex),
         numFiles_(numFiles),
-        useXorEncryption_(useXorEncryption) {}
+        useXorEncryption_(useXorEncryption),
+        fileIndexQueue_(std::move(fileIndexQueue)),
+        computeConvHistogram_(computeConvHistogram) {}
 
   void run();
 
@@ -67,6 +72,8 @@ class CalculatorApp {
 
   std::unique_ptr<fbpcf::scheduler::IScheduler> createScheduler();
 
+  void runOnFile(CalculatorGame<schedulerId>& game, size_t fileIndex);
+
  private:
   int party_;
   std::unique_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
@@ -82,6 +89,8 @@ class CalculatorApp {
   int startFileIndex_;
   int numFiles_;
   bool useXorEncryption_;
+  std::shared_ptr<common::FileIndexQueue> fileIndexQueue_;
+  bool computeConvHistogram_;
   common::SchedulerStatistics schedulerStatistics_;
 };
 
@@ -16,36 +16,35 @@ namespace private_lift {
 
 template <int schedulerId>
 void CalculatorApp<schedulerId>::run() {
-  // Run calculator game sequentially on numFiles files, starting from
-  // startFileIndex
   auto scheduler = createScheduler();
+
+  // The file assigner agent is created before the game takes ownership of
+  // the communication agent factory
+  std::unique_ptr<common::FileAssigner> fileAssigner = nullptr;
+  if (fileIndexQueue_ != nullptr) {
+    fileAssigner = std::make_unique<common::FileAssigner>(
+        party_,
+        fileIndexQueue_,
+        communicationAgentFactory_->create(1 - party_, "lift_file_assigner"));
+  }
+
   CalculatorGame<schedulerId> game{
-      party_, std::move(scheduler), std::move(communicationAgentFactory_)};
-
-  for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
-    try {
-      CHECK_LT(i, inputPaths_.size()) << "File index exceeds number of files.";
-      std::string output;
-      if (!readInputFromSecretShares_) {
-        CalculatorGameConfig config = getInputData(inputPaths_.at(i));
-        auto numRows = config.inputData.getNumRows();
-        XLOG(INFO) << "Have " << numRows << " values in inputData.";
-        output = game.play(config);
-      } else {
-        XLOG(INFO) << "Reading input data from secret shares.";
-        output = game.playFromSecretShares(
-            inputGlobalParamsPath_, inputPaths_.at(i), numConversionsPerUser_);
-      }
-
-      XLOG(INFO) << "done calculating";
-      putOutputData(output, outputPaths_.at(i));
-    } catch (const std::exception& e) {
-      XLOGF(
-          ERR,
-          "Error: Exception caught in CalculatorApp run.\n \t error msg: {} \n \t input shard: {}.",
-          e.what(),
-          inputPaths_.at(i));
-      std::exit(1);
+      party_,
+      std::move(scheduler),
+      std::move(communicationAgentFactory_),
+      computeConvHistogram_};
+
+  if (fileAssigner != nullptr) {
+    // Keep the game alive and run it on whichever file is handed out next,
+    // until all files are done
+    while (auto i = fileAssigner->next()) {
+      runOnFile(game, *i);
+    }
+  } else {
+    // Run calculator game sequentially on numFiles files, starting from
+    // startFileIndex
+    for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+      runOnFile(game, i);
     }
   }
 
@@ -73,6 +72,36 @@ void CalculatorApp<schedulerId>::run() {
   schedulerStatistics_.details = metricCollector_->collectMetrics();
 };
 
+template <int schedulerId>
+void CalculatorApp<schedulerId>::runOnFile(
+    CalculatorGame<schedulerId>& game,
+    size_t i) {
+  try {
+    CHECK_LT(i, inputPaths_.size()) << "File index exceeds number of files.";
+    std::string output;
+    if (!readInputFromSecretShares_) {
+      CalculatorGameConfig config = getInputData(inputPaths_.at(i));
+      auto numRows = config.inputData.getNumRows();
+      XLOG(INFO) << "Have " << numRows << " values in inputData.";
+      output = game.play(config);
+    } else {
+      XLOG(INFO) << "Reading input data from secret shares.";
+      output = game.playFromSecretShares(
+          inputGlobalParamsPath_, inputPaths_.at(i), numConversionsPerUser_);
+    }
+
+    XLOG(INFO) << "done calculating";
+    putOutputData(output, outputPaths_.at(i));
+  } catch (const std::exception& e) {
+    XLOGF(
+        ERR,
+        "Error: Exception caught in CalculatorApp run.\n \t error msg: {} \n \t input shard: {}.",
+        e.what(),
+        inputPaths_.at(i));
+    std::exit(1);
+  }
+}
+
 template <int schedulerId>
 CalculatorGameConfig CalculatorApp<schedulerId>::getInputData(
     const std::string& inputPath) {
@@ -26,10 +26,12 @@ class CalculatorGame : public fbpcf::frontend::MpcGame<schedulerId> {
       std::unique_ptr<fbpcf::scheduler::IScheduler> scheduler,
       std::shared_ptr<
           fbpcf::engine::communication::IPartyCommunicationAgentFactory>
-          communicationAgentFactory)
+          communicationAgentFactory,
+      bool computeConvHistogram = false)
       : fbpcf::frontend::MpcGame<schedulerId>(std::move(scheduler)),
         party_{party},
-        communicationAgentFactory_(communicationAgentFactory) {}
+        communicationAgentFactory_(communicationAgentFactory),
+        computeConvHistogram_{computeConvHistogram} {}
 
   std::string play(const CalculatorGameConfig& config) {
     if (config.inputData.getNumRows() == 0) {
@@ -41,7 +43,9 @@ class CalculatorGame : public fbpcf::frontend::MpcGame<schedulerId> {
     auto inputProcessor = InputProcessor<schedulerId>(
         party_, config.inputData, config.numConversionsPerUser);
     auto attributor = std::make_unique<Attributor<schedulerId>>(
-        party_, std::make_unique<InputProcessor<schedulerId>>(inputProcessor));
+        party_,
+        std::make_unique<InputProcessor<schedulerId>>(inputProcessor),
+        computeConvHistogram_);
     auto aggregator = Aggregator<schedulerId>(
         party_,
         std::make_unique<InputProcessor<schedulerId>>(
@@ -69,7 +73,8 @@ class CalculatorGame : public fbpcf::frontend::MpcGame<schedulerId> {
     auto attributor = std::make_unique<Attributor<schedulerId>>(
         party_,
         std::make_unique<SecretShareInputProcessor<schedulerId>>(
-            inputProcessor));
+            inputProcessor),
+        computeConvHistogram_);
     auto aggregator = Aggregator<schedulerId>(
         party_,
         std::make_unique<SecretShareInputProcessor<schedulerId>>(
@@ -84,5 +89,6 @@ class CalculatorGame : public fbpcf::frontend::MpcGame<schedulerId> {
   const int party_;
   std::shared_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
       communicationAgentFactory_;
+  bool computeConvHistogram_;
 };
 } // namespace private_lift
@@ -12,6 +12,7 @@
 
 #include <folly/dynamic.h>
 #include "fbpcf/engine/communication/SocketPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/lift/pcf2_calculator/CalculatorApp.h"
 
 namespace private_lift {
@@ -60,7 +61,7 @@ getIOFilepaths(
 
 template <int PARTY, int index>
 inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
-    int startFileIndex,
+    std::shared_ptr<common::FileIndexQueue> fileIndexQueue,
     int remainingThreads,
     int numThreads,
     std::string serverIp,
@@ -71,6 +72,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
     bool readInputFromSecretShares,
     int numConversionsPerUser,
     bool computePublisherBreakdowns,
+    bool computeConvHistogram,
     int epoch,
     bool useXorEncryption,
     fbpcf::engine::communication::SocketPartyCommunicationAgent::TlsInfo&
@@ -79,13 +81,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
   common::SchedulerStatistics schedulerStatistics{
       0, 0, 0, 0, folly::dynamic::object()};
 
-  // split files evenly across threads
-  auto remainingFiles = inputFilepaths.size() - startFileIndex;
-  if (remainingFiles > 0) {
-    auto numFiles = (remainingThreads > remainingFiles)
-        ? 1
-        : (remainingFiles / remainingThreads);
-
+  if (remainingThreads > 0) {
     std::map<
         int,
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory::
@@ -101,7 +97,8 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory>(
         PARTY, partyInfos, tlsInfo, metricCollector);
 
-    // Each CalculatorApp runs numFiles sequentially on a single thread
+    // Each CalculatorApp keeps its scheduler on a single thread and takes
+    // files from the shared queue until all files are done.
     // Publisher uses even schedulerId and partner uses odd schedulerId
     auto app = std::make_unique<CalculatorApp<2 * index + PARTY>>(
         PARTY,
@@ -114,9 +111,11 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
         outputFilepaths,
         readInputFromSecretShares,
         metricCollector,
-        startFileIndex,
-        numFiles,
-        useXorEncryption);
+        0,
+        0,
+        useXorEncryption,
+        fileIndexQueue,
+        computeConvHistogram);
 
     auto future = std::async([&app]() {
       app->run();
@@ -129,7 +128,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
       if (remainingThreads > 1) {
         auto remainingStats =
             startCalculatorAppsForShardedFilesHelper<PARTY, index + 1>(
-                startFileIndex + numFiles,
+                fileIndexQueue,
                 remainingThreads - 1,
                 numThreads,
                 serverIp,
@@ -140,6 +139,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFilesHelper(
                 readInputFromSecretShares,
                 numConversionsPerUser,
                 computePublisherBreakdowns,
+                computeConvHistogram,
                 epoch,
                 useXorEncryption,
                 tlsInfo);
@@ -163,6 +163,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFiles(
     int port,
     int numConversionsPerUser,
     bool computePublisherBreakdowns,
+    bool computeConvHistogram,
     int epoch,
     bool useXorEncryption,
     fbpcf::engine::communication::SocketPartyCommunicationAgent::TlsInfo&
@@ -171,7 +172,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFiles(
   auto numThreads = std::min((int)inputFilepaths.size(), (int)concurrency);
 
   return startCalculatorAppsForShardedFilesHelper<PARTY, 0>(
-      0,
+      std::make_shared<common::FileIndexQueue>(inputFilepaths.size()),
       numThreads,
       numThreads,
       serverIp,
@@ -182,6 +183,7 @@ inline common::SchedulerStatistics startCalculatorAppsForShardedFiles(
       readInputFromSecretShares,
       numConversionsPerUser,
       computePublisherBreakdowns,
+      computeConvHistogram,
       epoch,
       useXorEncryption,
       tlsInfo);
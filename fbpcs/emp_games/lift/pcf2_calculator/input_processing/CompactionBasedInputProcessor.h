@@ -7,7 +7,12 @@
 
 #pragma once
 
+#include <future>
+#include <memory>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 #include "fbpcf/engine/util/IPrg.h"
 #include "folly/logging/xlog.h"
 
@@ -23,7 +28,9 @@
 namespace private_lift {
 /**
  * This class handles privately sharing all the input data in MPC. It will
- * handle obliviously filtering out rows with dummy entries.
+ * handle obliviously filtering out rows with dummy entries. The adapter and
+ * data processor are shared so that a game can reuse the same protocol
+ * objects across every shard it processes on one scheduler.
  */
 template <int schedulerId>
 class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
@@ -33,9 +40,9 @@ class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
 
   CompactionBasedInputProcessor(
       int myRole,
-      std::unique_ptr<
+      std::shared_ptr<
           fbpcf::mpc_std_lib::unified_data_process::adapter::IAdapter> adapter,
-      std::unique_ptr<fbpcf::mpc_std_lib::unified_data_process::data_processor::
+      std::shared_ptr<fbpcf::mpc_std_lib::unified_data_process::data_processor::
                           IDataProcessor<schedulerId>> dataProcessor,
       std::unique_ptr<fbpcf::engine::util::IPrg> prg,
       InputData inputData,
@@ -59,23 +66,42 @@ class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
     input_processing::shareBitsForValuesStep(
         myRole_, inputData_, liftGameProcessedData_);
 
+    // The adapter and data processor run once over the whole shard, so the
+    // parties learn only the size of the whole intersection. Serializing the
+    // plaintext rows needs nothing but the union map, so it runs on a worker
+    // thread while this thread runs the adapter rounds. Only this thread
+    // touches the scheduler and the protocol objects.
     auto unionMap = shuffleAndGetUnionMap();
+    auto plaintextDataFuture =
+        std::async(std::launch::async, [this, &unionMap]() {
+          return preparePlaintextData(unionMap);
+        });
 
     auto intersectionMap = getIntersectionMap(unionMap);
+    auto plaintextData = plaintextDataFuture.get();
+
+    CompactedColumns compactedColumns;
+    if (intersectionMap.size() > 0) {
+      auto publisherPartnerJointMetadataShares =
+          compactData(intersectionMap, plaintextData);
+      plaintextData.clear();
+
+      deserializeSecretSharedData(
+          compactedColumns,
+          std::get<0>(publisherPartnerJointMetadataShares)
+              .extractStringShare()
+              .getValue(),
+          std::get<1>(publisherPartnerJointMetadataShares)
+              .extractStringShare()
+              .getValue());
+    }
 
-    if (intersectionMap.size() == 0) {
+    if (compactedColumns.cohortGroupId.size() == 0) {
       liftGameProcessedData_ = {};
       return;
     }
 
-    auto plaintextData = preparePlaintextData(unionMap);
-
-    auto publisherPartnerJointMetadataShares =
-        compactData(intersectionMap, plaintextData);
-
-    extractCompactedData(
-        std::get<0>(publisherPartnerJointMetadataShares),
-        std::get<1>(publisherPartnerJointMetadataShares));
+    extractCompactedData(std::move(compactedColumns));
 
     input_processing::computeIndexSharesAndSetTestGroupIds(
         liftGameProcessedData_,
@@ -122,6 +148,35 @@ class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
   const int PARTNER_CONVERSION_ROW_SIZE_BYTES = 20;
   const int PUBLISHER_ROW_BYTES = 5;
 
+  // Byte offsets of the fields within a serialized row. Partner conversion
+  // offsets are relative to the start of each conversion.
+  static constexpr size_t kAnyValidPurchaseTimestampOffset = 0;
+  static constexpr size_t kCohortGroupIdOffset = 1;
+  static constexpr size_t kFirstPartnerConversionOffset = 5;
+  static constexpr size_t kPurchaseTimestampOffset = 0;
+  static constexpr size_t kThresholdTimestampOffset = 4;
+  static constexpr size_t kPurchaseValueOffset = 8;
+  static constexpr size_t kPurchaseValueSquaredOffset = 12;
+  static constexpr size_t kPublisherFlagsOffset = 0;
+  static constexpr size_t kOpportunityTimestampOffset = 1;
+
+  // Secret shares of the compacted rows, one vector per column, ready to be
+  // wrapped into MPC types. The conversion columns hold one vector per
+  // conversion.
+  struct CompactedColumns {
+    std::vector<bool> anyValidPurchaseTimestamp;
+    std::vector<uint64_t> cohortGroupId;
+    std::vector<std::vector<uint64_t>> purchaseTimestamps;
+    std::vector<std::vector<uint64_t>> thresholdTimestamps;
+    std::vector<std::vector<int64_t>> purchaseValues;
+    std::vector<std::vector<int64_t>> purchaseValueSquared;
+    std::vector<bool> breakdownId;
+    std::vector<bool> controlPopulation;
+    std::vector<bool> isValidOpportunityTimestamp;
+    std::vector<bool> testReach;
+    std::vector<uint64_t> opportunityTimestamp;
+  };
+
   // unionMap[i] = j indicates PID i will point to index j in plaintext data
   // note that j in [0,intersectionSize) rather than [0, unionSize)
   // unionMap[i] = -1 indicates PID i is a dummy row
@@ -130,11 +185,17 @@ class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
   // runs adapter algorithm to get intsersection map
   std::vector<int32_t> getIntersectionMap(const std::vector<int32_t>& unionMap);
 
-  // Serializes input data into rows of fixed width. Different implementations
-  // for publisher and partner
+  // Serializes input data into rows of fixed width. This is local only.
   std::vector<std::vector<unsigned char>> preparePlaintextData(
       const std::vector<int32_t>& unionMap);
 
+  // Serializes every plaintext row into rst, reverseUnionMap[j] being the
+  // input row of plaintext row j. Different implementations for publisher and
+  // partner.
+  void serializeRows(
+      const std::vector<int64_t>& reverseUnionMap,
+      std::vector<std::vector<unsigned char>>& rst) const;
+
   /* Runs data processor algorithm to get intersected secret share data
    * intersectionMap is the map of other player. First element is publisher
    * metadata shares, second is partner metadata shares
@@ -143,69 +204,88 @@ class CompactionBasedInputProcessor : public IInputProcessor<schedulerId> {
       const std::vector<int32_t>& intersectionMap,
       const std::vector<std::vector<unsigned char>>& plaintextData);
 
-  // deserializes the compacted data into MPC structured values
-  void extractCompactedData(
-      const SecString& publisherDataShares,
-      const SecString& partnerDataShares);
+  // converts the compacted columns into MPC structured values
+  void extractCompactedData(CompactedColumns compactedColumns);
 
-  std::tuple<
-      std::vector<PartnerRow>,
-      std::vector<std::vector<PartnerConversionRow>>,
-      std::vector<PublisherRow>>
-  deserializeSecretSharedData(
-      const SecString& publisherDataShares,
-      const SecString& partnerDataShares);
+  /* Appends the extracted shares of the compacted rows to compactedColumns.
+   * The string shares are bit-sliced, i.e. one vector per bit of the
+   * serialized row, so every column is read straight from the bits it was
+   * serialized to.
+   */
+  void deserializeSecretSharedData(
+      CompactedColumns& compactedColumns,
+      const std::vector<std::vector<bool>>& publisherSecretSharedBits,
+      const std::vector<std::vector<bool>>& partnerSecretSharedBits);
 
-  void extractPartnerValues(const std::vector<PartnerRow>& partnerRows);
+  void extractPartnerValues(CompactedColumns& compactedColumns);
 
-  void extractPartnerConversionValues(
-      const std::vector<std::vector<PartnerConversionRow>>&
-          partnerConversionRows);
+  void extractPartnerConversionValues(CompactedColumns& compactedColumns);
 
-  void extractPublisherValues(const std::vector<PublisherRow>& publisherRows);
+  void extractPublisherValues(CompactedColumns& compactedColumns);
 
   template <typename T>
-  unsigned char extractByte(T val, size_t byte) {
-    if (byte < 0 || byte >= sizeof(T)) {
-      throw std::invalid_argument("Not enough bytes in type");
-    }
-
-    return (uint8_t)(val >> 8 * byte);
+  static T
+  valueOrPadding(const std::vector<T>& values, size_t index, T paddingValue) {
+    return index < values.size() ? values[index] : paddingValue;
   }
 
   template <typename T>
-  T reconstructFromBytes(unsigned char* data) {
-    T val = 0;
-    for (size_t i = 0; i < sizeof(T); i++) {
-      val |= ((T) * (data + i)) << (i * 8);
-    }
-    return val;
+  static T valueOrPadding(
+      const std::vector<std::vector<T>>& values,
+      size_t row,
+      size_t column,
+      T paddingValue) {
+    return (row < values.size() && column < values[row].size())
+        ? values[row][column]
+        : paddingValue;
   }
 
-  std::vector<unsigned char> convertFromBits(std::vector<bool> data) {
-    std::vector<unsigned char> rst;
-    rst.reserve(data.size() / 8);
+  template <typename T>
+  static unsigned char extractByte(T val, size_t byte) {
+    if (byte < 0 || byte >= sizeof(T)) {
+      throw std::invalid_argument("Not enough bytes in type");
+    }
 
-    size_t i = 0;
+    return (uint8_t)(val >> 8 * byte);
+  }
 
-    while (i < data.size()) {
-      unsigned char val = 0;
-      size_t bitsLeft = data.size() - i > 8 ? 8 : data.size() - i;
-      for (auto j = 0; j < bitsLeft; j++) {
-        val |= (data[i] << j);
-        ++i;
+  // Appends the shares of the T serialized at byteOffset in every row of the
+  // bit-sliced shares to column. The bits of a row are laid out byte by byte,
+  // least significant bit first.
+  template <typename T, typename ShareType>
+  static void appendColumn(
+      std::vector<ShareType>& column,
+      const std::vector<std::vector<bool>>& bitShares,
+      size_t byteOffset) {
+    using UnsignedT = std::make_unsigned_t<T>;
+    size_t numRows = bitShares.at(byteOffset * 8).size();
+    std::vector<UnsignedT> values(numRows, 0);
+    for (size_t bit = 0; bit < sizeof(T) * 8; bit++) {
+      const auto& bitShare = bitShares.at(byteOffset * 8 + bit);
+      for (size_t row = 0; row < numRows; row++) {
+        values[row] |= static_cast<UnsignedT>(bitShare[row]) << bit;
       }
-      rst.push_back(val);
     }
+    column.reserve(column.size() + numRows);
+    for (auto value : values) {
+      column.push_back(static_cast<T>(value));
+    }
+  }
 
-    return rst;
+  // Appends the shares of the bit at bitOffset in every row to column
+  static void appendBitColumn(
+      std::vector<bool>& column,
+      const std::vector<std::vector<bool>>& bitShares,
+      size_t bitOffset) {
+    const auto& bitShare = bitShares.at(bitOffset);
+    column.insert(column.end(), bitShare.begin(), bitShare.end());
   }
 
   int32_t myRole_;
 
-  std::unique_ptr<fbpcf::mpc_std_lib::unified_data_process::adapter::IAdapter>
+  std::shared_ptr<fbpcf::mpc_std_lib::unified_data_process::adapter::IAdapter>
       adapter_;
-  std::unique_ptr<fbpcf::mpc_std_lib::unified_data_process::data_processor::
+  std::shared_ptr<fbpcf::mpc_std_lib::unified_data_process::data_processor::
                       IDataProcessor<schedulerId>>
       dataProcessor_;
   std::unique_ptr<fbpcf::engine::util::IPrg> prg_;
@@ -9,7 +9,7 @@
 
 #include <algorithm>
 #include <functional>
-#include <iterator>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 #include <tuple>
@@ -26,13 +26,19 @@ template <int schedulerId>
 std::vector<int32_t>
 CompactionBasedInputProcessor<schedulerId>::shuffleAndGetUnionMap() {
   XLOG(INFO) << "Shuffling input and preparing Union Map for Adapter input";
+  // the adapter works on int32_t indices
+  if (inputData_.getNumRows() > std::numeric_limits<int32_t>::max()) {
+    throw std::invalid_argument(folly::sformat(
+        "{} rows do not fit the int32_t indices of the adapter",
+        inputData_.getNumRows()));
+  }
   int32_t unionSize = inputData_.getNumRows();
   const std::vector<uint32_t> randomPermutation =
       fbpcf::mpc_std_lib::util::secureRandomPermutation(unionSize, *prg_);
   std::vector<int32_t> unionMap(unionSize);
   const std::vector<bool>& dummyRows = inputData_.getDummyRows();
   int32_t nonDummyRows = 0;
-  for (int32_t i = 0; i < unionMap.size(); i++) {
+  for (int32_t i = 0; i < unionSize; i++) {
     unionMap[randomPermutation[i]] =
         dummyRows[randomPermutation[i]] ? -1 : nonDummyRows++;
   }
@@ -51,11 +57,9 @@ template <int schedulerId>
 std::vector<std::vector<unsigned char>>
 CompactionBasedInputProcessor<schedulerId>::preparePlaintextData(
     const std::vector<int32_t>& unionMap) {
-  std::vector<std::vector<unsigned char>> rst;
   XLOG(INFO) << "Begin plaintext data serialization as bytes";
-  size_t unionSize = inputData_.getNumRows();
   int32_t inputSize = 0;
-  std::vector<int32_t> reverseUnionMap(inputData_.getNumRows());
+  std::vector<int64_t> reverseUnionMap(unionMap.size());
 
   for (int i = 0; i < unionMap.size(); i++) {
     if (unionMap[i] >= 0) {
@@ -67,52 +71,53 @@ CompactionBasedInputProcessor<schedulerId>::preparePlaintextData(
   inputSize++;
   reverseUnionMap.resize(inputSize);
 
-  rst.reserve(inputSize);
+  std::vector<std::vector<unsigned char>> rst(inputSize);
+  serializeRows(reverseUnionMap, rst);
 
+  return rst;
+}
+
+template <int schedulerId>
+void CompactionBasedInputProcessor<schedulerId>::serializeRows(
+    const std::vector<int64_t>& reverseUnionMap,
+    std::vector<std::vector<unsigned char>>& rst) const {
   if (myRole_ == common::PARTNER) {
-    auto cohortIdsPadded =
-        common::padArray<uint32_t>(inputData_.getGroupIds(), unionSize, 0);
-    auto purchaseTimestampsPadded = common::padNestedArrays<uint32_t>(
-        inputData_.getPurchaseTimestampArrays(),
-        unionSize,
-        numConversionsPerUser_,
-        0);
-    auto purchaseValuesPadded = common::padNestedArrays<int64_t>(
-        inputData_.getPurchaseValueArrays(),
-        unionSize,
-        numConversionsPerUser_,
-        0);
-    auto purchaseValuesSquaredPadded = common::padNestedArrays<int64_t>(
-        inputData_.getPurchaseValueSquaredArrays(),
-        unionSize,
-        numConversionsPerUser_,
-        0);
-
-    for (size_t i = 0; i < inputSize; i++) {
-      int inputIndex = reverseUnionMap[i];
+    const auto& cohortIds = inputData_.getGroupIds();
+    const auto& purchaseTimestamps = inputData_.getPurchaseTimestampArrays();
+    const auto& purchaseValues = inputData_.getPurchaseValueArrays();
+    const auto& purchaseValuesSquared =
+        inputData_.getPurchaseValueSquaredArrays();
+
+    for (size_t i = 0; i < rst.size(); i++) {
+      int64_t inputIndex = reverseUnionMap[i];
 
       bool anyValidPurchaseTimestamp = false;
-      for (uint32_t purchaseTs : purchaseTimestampsPadded[inputIndex]) {
+      for (size_t j = 0; j < numConversionsPerUser_; j++) {
         // compute whether each row contains at least one valid (positive)
         // purchase timestamp
-        anyValidPurchaseTimestamp |= (purchaseTs > 0);
+        anyValidPurchaseTimestamp |=
+            (valueOrPadding<uint32_t>(purchaseTimestamps, inputIndex, j, 0) >
+             0);
       }
 
       PartnerRow partnerRow{
           .anyValidPurchaseTimestamp = anyValidPurchaseTimestamp,
-          .cohortGroupId = cohortIdsPadded[inputIndex]};
+          .cohortGroupId = valueOrPadding<uint32_t>(cohortIds, inputIndex, 0)};
 
       std::vector<PartnerConversionRow> rowConversions(numConversionsPerUser_);
 
       for (size_t j = 0; j < numConversionsPerUser_; j++) {
+        auto purchaseTimestamp =
+            valueOrPadding<uint32_t>(purchaseTimestamps, inputIndex, j, 0);
         rowConversions[j] = {
-            .purchaseTimestamp = purchaseTimestampsPadded[inputIndex][j],
-            .thresholdTimestamp = purchaseTimestampsPadded[inputIndex][j] > 0
-                ? purchaseTimestampsPadded[inputIndex][j] +
-                    kPurchaseTimestampThresholdWindow
+            .purchaseTimestamp = purchaseTimestamp,
+            .thresholdTimestamp = purchaseTimestamp > 0
+                ? purchaseTimestamp + kPurchaseTimestampThresholdWindow
                 : 0,
-            .purchaseValue = (int32_t)purchaseValuesPadded[inputIndex][j],
-            .purchaseValueSquared = purchaseValuesSquaredPadded[inputIndex][j]};
+            .purchaseValue = (int32_t)valueOrPadding<int64_t>(
+                purchaseValues, inputIndex, j, 0),
+            .purchaseValueSquared = valueOrPadding<int64_t>(
+                purchaseValuesSquared, inputIndex, j, 0)};
       }
 
       std::vector<unsigned char> serialized(
@@ -141,36 +146,36 @@ CompactionBasedInputProcessor<schedulerId>::preparePlaintextData(
         }
       }
 
-      rst.push_back(serialized);
+      rst[i] = std::move(serialized);
     }
   } else {
-    auto opportunityTimestampsPadded = common::padArray<uint32_t>(
-        inputData_.getOpportunityTimestamps(), unionSize, 0);
-    auto controlPopulationPadded = common::padArray<bool>(
-        inputData_.getControlPopulation(), unionSize, false);
-    auto testPopulationPadded = common::padArray<bool>(
-        inputData_.getTestPopulation(), unionSize, false);
-    auto numImpressionsPadded =
-        common::padArray<int64_t>(inputData_.getNumImpressions(), unionSize, 0);
-    auto breakdownIdPadded =
-        common::padArray<uint32_t>(inputData_.getBreakdownIds(), unionSize, 0);
-    for (size_t i = 0; i < inputSize; i++) {
-      int inputIndex = reverseUnionMap[i];
+    const auto& opportunityTimestamps = inputData_.getOpportunityTimestamps();
+    const auto& controlPopulation = inputData_.getControlPopulation();
+    const auto& testPopulation = inputData_.getTestPopulation();
+    const auto& numImpressions = inputData_.getNumImpressions();
+    const auto& breakdownIds = inputData_.getBreakdownIds();
+    for (size_t i = 0; i < rst.size(); i++) {
+      int64_t inputIndex = reverseUnionMap[i];
+
+      auto opportunityTimestamp =
+          valueOrPadding<uint32_t>(opportunityTimestamps, inputIndex, 0);
+      bool isControl =
+          valueOrPadding<bool>(controlPopulation, inputIndex, false);
+      bool isTest = valueOrPadding<bool>(testPopulation, inputIndex, false);
 
       bool isValidOpportunityTimestamp =
-          (opportunityTimestampsPadded.at(inputIndex) > 0) &
-          (controlPopulationPadded.at(inputIndex) |
-           testPopulationPadded.at(inputIndex));
+          (opportunityTimestamp > 0) & (isControl | isTest);
 
-      bool testReach = testPopulationPadded.at(inputIndex) &
-          (numImpressionsPadded.at(inputIndex) > 0);
+      bool testReach = isTest &
+          (valueOrPadding<int64_t>(numImpressions, inputIndex, 0) > 0);
 
       PublisherRow publisherRow{
-          .breakdownId = (bool)breakdownIdPadded[inputIndex],
-          .controlPopulation = controlPopulationPadded[inputIndex],
+          .breakdownId =
+              (bool)valueOrPadding<uint32_t>(breakdownIds, inputIndex, 0),
+          .controlPopulation = isControl,
           .isValidOpportunityTimestamp = isValidOpportunityTimestamp,
           .testReach = testReach,
-          .opportunityTimestamp = opportunityTimestampsPadded[inputIndex],
+          .opportunityTimestamp = opportunityTimestamp,
       };
 
       std::vector<unsigned char> serialized(PUBLISHER_ROW_BYTES);
@@ -184,11 +189,9 @@ CompactionBasedInputProcessor<schedulerId>::preparePlaintextData(
             extractByte(publisherRow.opportunityTimestamp, byte);
       }
 
-      rst.push_back(serialized);
+      rst[i] = std::move(serialized);
     }
   }
-
-  return rst;
 }
 
 template <int schedulerId>
@@ -277,129 +280,96 @@ CompactionBasedInputProcessor<schedulerId>::compactData(
 
 template <int schedulerId>
 void CompactionBasedInputProcessor<schedulerId>::extractCompactedData(
-    const typename CompactionBasedInputProcessor<schedulerId>::SecString&
-        publisherDataShares,
-    const typename CompactionBasedInputProcessor<schedulerId>::SecString&
-        partnerDataShares) {
+    CompactedColumns compactedColumns) {
   XLOG(INFO, "Begin extraction to MPC types");
 
-  liftGameProcessedData_.numRows = publisherDataShares.getBatchSize();
-
-  std::tuple<
-      std::vector<PartnerRow>,
-      std::vector<std::vector<PartnerConversionRow>>,
-      std::vector<PublisherRow>>
-      deserializedSecretStructs =
-          deserializeSecretSharedData(publisherDataShares, partnerDataShares);
+  liftGameProcessedData_.numRows = compactedColumns.cohortGroupId.size();
 
-  extractPartnerValues(std::get<0>(deserializedSecretStructs));
-  extractPartnerConversionValues(std::get<1>(deserializedSecretStructs));
-  extractPublisherValues(std::get<2>(deserializedSecretStructs));
+  extractPartnerValues(compactedColumns);
+  extractPartnerConversionValues(compactedColumns);
+  extractPublisherValues(compactedColumns);
 
   XLOG(INFO, "Finish extraction to MPC types");
 }
 
 template <int schedulerId>
-std::tuple<
-    std::vector<
-        typename CompactionBasedInputProcessor<schedulerId>::PartnerRow>,
-    std::vector<std::vector<typename CompactionBasedInputProcessor<
-        schedulerId>::PartnerConversionRow>>,
-    std::vector<
-        typename CompactionBasedInputProcessor<schedulerId>::PublisherRow>>
-CompactionBasedInputProcessor<schedulerId>::deserializeSecretSharedData(
-    const SecString& publisherDataShares,
-    const SecString& partnerDataShares) {
-  std::vector<std::vector<bool>> publisherSecretSharedBits =
-      publisherDataShares.extractStringShare().getValue();
-  publisherSecretSharedBits = common::transpose(publisherSecretSharedBits);
-
-  std::vector<std::vector<bool>> partnerSecretSharedBits =
-      partnerDataShares.extractStringShare().getValue();
-  partnerSecretSharedBits = common::transpose(partnerSecretSharedBits);
-
-  std::vector<std::vector<PartnerConversionRow>> partnerConversionRows(
-      liftGameProcessedData_.numRows);
-  std::vector<PartnerRow> partnerRows(liftGameProcessedData_.numRows);
-  std::vector<PublisherRow> publisherRows(liftGameProcessedData_.numRows);
-
-  for (size_t i = 0; i < liftGameProcessedData_.numRows; i++) {
-    auto publisherByteShares = convertFromBits(publisherSecretSharedBits.at(i));
-    auto partnerByteShares = convertFromBits(partnerSecretSharedBits.at(i));
-
-    publisherRows[i].breakdownId = publisherByteShares[0] & 1;
-    publisherRows[i].controlPopulation = (publisherByteShares[0] >> 1) & 1;
-    publisherRows[i].isValidOpportunityTimestamp =
-        (publisherByteShares[0] >> 2) & 1;
-    publisherRows[i].testReach = (publisherByteShares[0] >> 3) & 1;
-    publisherRows[i].opportunityTimestamp =
-        reconstructFromBytes<uint32_t>(publisherByteShares.data() + 1);
-
-    partnerRows[i].anyValidPurchaseTimestamp = partnerByteShares[0] & 1;
-    partnerRows[i].cohortGroupId =
-        reconstructFromBytes<uint32_t>(partnerByteShares.data() + 1);
-
-    partnerConversionRows[i] =
-        std::vector<PartnerConversionRow>(numConversionsPerUser_);
-
-    for (size_t j = 0; j < numConversionsPerUser_; j++) {
-      partnerConversionRows[i][j].purchaseTimestamp =
-          reconstructFromBytes<uint32_t>(
-              partnerByteShares.data() + 5 +
-              j * PARTNER_CONVERSION_ROW_SIZE_BYTES);
-      partnerConversionRows[i][j].thresholdTimestamp =
-          reconstructFromBytes<uint32_t>(
-              partnerByteShares.data() + 9 +
-              j * PARTNER_CONVERSION_ROW_SIZE_BYTES);
-
-      partnerConversionRows[i][j].purchaseValue = reconstructFromBytes<int32_t>(
-          partnerByteShares.data() + 13 +
-          j * PARTNER_CONVERSION_ROW_SIZE_BYTES);
-
-      partnerConversionRows[i][j].purchaseValueSquared =
-          reconstructFromBytes<int64_t>(
-              partnerByteShares.data() + 17 +
-              j * PARTNER_CONVERSION_ROW_SIZE_BYTES);
-    }
+void CompactionBasedInputProcessor<schedulerId>::deserializeSecretSharedData(
+    CompactedColumns& compactedColumns,
+    const std::vector<std::vector<bool>>& publisherSecretSharedBits,
+    const std::vector<std::vector<bool>>& partnerSecretSharedBits) {
+  appendBitColumn(
+      compactedColumns.anyValidPurchaseTimestamp,
+      partnerSecretSharedBits,
+      kAnyValidPurchaseTimestampOffset * 8);
+  appendColumn<uint32_t>(
+      compactedColumns.cohortGroupId,
+      partnerSecretSharedBits,
+      kCohortGroupIdOffset);
+
+  compactedColumns.purchaseTimestamps.resize(numConversionsPerUser_);
+  compactedColumns.thresholdTimestamps.resize(numConversionsPerUser_);
+  compactedColumns.purchaseValues.resize(numConversionsPerUser_);
+  compactedColumns.purchaseValueSquared.resize(numConversionsPerUser_);
+  for (size_t j = 0; j < numConversionsPerUser_; j++) {
+    size_t conversionOffset =
+        kFirstPartnerConversionOffset + j * PARTNER_CONVERSION_ROW_SIZE_BYTES;
+    appendColumn<uint32_t>(
+        compactedColumns.purchaseTimestamps[j],
+        partnerSecretSharedBits,
+        conversionOffset + kPurchaseTimestampOffset);
+    appendColumn<uint32_t>(
+        compactedColumns.thresholdTimestamps[j],
+        partnerSecretSharedBits,
+        conversionOffset + kThresholdTimestampOffset);
+    appendColumn<int32_t>(
+        compactedColumns.purchaseValues[j],
+        partnerSecretSharedBits,
+        conversionOffset + kPurchaseValueOffset);
+    appendColumn<int64_t>(
+        compactedColumns.purchaseValueSquared[j],
+        partnerSecretSharedBits,
+        conversionOffset + kPurchaseValueSquaredOffset);
   }
 
-  return std::make_tuple<
-      std::vector<
-          typename CompactionBasedInputProcessor<schedulerId>::PartnerRow>,
-      std::vector<std::vector<typename CompactionBasedInputProcessor<
-          schedulerId>::PartnerConversionRow>>,
-      std::vector<
-          typename CompactionBasedInputProcessor<schedulerId>::PublisherRow>>(
-      std::move(partnerRows),
-      std::move(partnerConversionRows),
-      std::move(publisherRows));
+  // The publisher flags are packed into the first byte, see
+  // preparePlaintextData
+  appendBitColumn(
+      compactedColumns.breakdownId,
+      publisherSecretSharedBits,
+      kPublisherFlagsOffset * 8);
+  appendBitColumn(
+      compactedColumns.controlPopulation,
+      publisherSecretSharedBits,
+      kPublisherFlagsOffset * 8 + 1);
+  appendBitColumn(
+      compactedColumns.isValidOpportunityTimestamp,
+      publisherSecretSharedBits,
+      kPublisherFlagsOffset * 8 + 2);
+  appendBitColumn(
+      compactedColumns.testReach,
+      publisherSecretSharedBits,
+      kPublisherFlagsOffset * 8 + 3);
+  appendColumn<uint32_t>(
+      compactedColumns.opportunityTimestamp,
+      publisherSecretSharedBits,
+      kOpportunityTimestampOffset);
 }
 
 template <int schedulerId>
 void CompactionBasedInputProcessor<schedulerId>::extractPartnerValues(
-    const std::vector<PartnerRow>& partnerRows) {
-  std::vector<bool> anyValidPurchaseTimestampShares(
-      liftGameProcessedData_.numRows);
-  std::vector<uint64_t> groupIdShares(liftGameProcessedData_.numRows);
-
-  for (int row = 0; row < liftGameProcessedData_.numRows; row++) {
-    anyValidPurchaseTimestampShares[row] =
-        partnerRows[row].anyValidPurchaseTimestamp;
-    groupIdShares[row] = partnerRows[row].cohortGroupId;
-  }
-
+    CompactedColumns& compactedColumns) {
   liftGameProcessedData_.anyValidPurchaseTimestamp =
       SecBit<schedulerId>(typename SecBit<schedulerId>::ExtractedBit(
-          anyValidPurchaseTimestampShares));
+          std::move(compactedColumns.anyValidPurchaseTimestamp)));
 
-  cohortGroupIds_ = SecGroup<schedulerId>(
-      typename SecGroup<schedulerId>::ExtractedInt(groupIdShares));
+  cohortGroupIds_ =
+      SecGroup<schedulerId>(typename SecGroup<schedulerId>::ExtractedInt(
+          std::move(compactedColumns.cohortGroupId)));
 }
 
 template <int schedulerId>
 void CompactionBasedInputProcessor<schedulerId>::extractPartnerConversionValues(
-    const std::vector<std::vector<PartnerConversionRow>>&
-        partnerConversionRows) {
+    CompactedColumns& compactedColumns) {
   liftGameProcessedData_.purchaseTimestamps =
       std::vector<SecTimestamp<schedulerId>>(numConversionsPerUser_);
   liftGameProcessedData_.thresholdTimestamps =
@@ -410,74 +380,42 @@ void CompactionBasedInputProcessor<schedulerId>::extractPartnerConversionValues(
       std::vector<SecValueSquared<schedulerId>>(numConversionsPerUser_);
 
   for (int conversion = 0; conversion < numConversionsPerUser_; conversion++) {
-    std::vector<uint64_t> purchaseTimestampShares(
-        liftGameProcessedData_.numRows);
-    std::vector<uint64_t> thresholdTimestampShares(
-        liftGameProcessedData_.numRows);
-    std::vector<int64_t> purchaseValueShares(liftGameProcessedData_.numRows);
-    std::vector<int64_t> purchaseValueSquaredShares(
-        liftGameProcessedData_.numRows);
-
-    for (int row = 0; row < liftGameProcessedData_.numRows; row++) {
-      purchaseTimestampShares[row] =
-          partnerConversionRows[row][conversion].purchaseTimestamp;
-      thresholdTimestampShares[row] =
-          partnerConversionRows[row][conversion].thresholdTimestamp;
-      purchaseValueShares[row] =
-          partnerConversionRows[row][conversion].purchaseValue;
-      purchaseValueSquaredShares[row] =
-          partnerConversionRows[row][conversion].purchaseValueSquared;
-    }
-
     liftGameProcessedData_.purchaseTimestamps[conversion] =
         SecTimestamp<schedulerId>(
-            typename SecTimestamp<schedulerId>::ExtractedInt(
-                purchaseTimestampShares));
+            typename SecTimestamp<schedulerId>::ExtractedInt(std::move(
+                compactedColumns.purchaseTimestamps[conversion])));
     liftGameProcessedData_.thresholdTimestamps[conversion] =
         SecTimestamp<schedulerId>(
-            typename SecTimestamp<schedulerId>::ExtractedInt(
-                thresholdTimestampShares));
+            typename SecTimestamp<schedulerId>::ExtractedInt(std::move(
+                compactedColumns.thresholdTimestamps[conversion])));
     liftGameProcessedData_.purchaseValues[conversion] = SecValue<schedulerId>(
-        typename SecValue<schedulerId>::ExtractedInt(purchaseValueShares));
+        typename SecValue<schedulerId>::ExtractedInt(
+            std::move(compactedColumns.purchaseValues[conversion])));
 
     liftGameProcessedData_.purchaseValueSquared[conversion] =
         SecValueSquared<schedulerId>(
-            typename SecValueSquared<schedulerId>::ExtractedInt(
-                purchaseValueSquaredShares));
+            typename SecValueSquared<schedulerId>::ExtractedInt(std::move(
+                compactedColumns.purchaseValueSquared[conversion])));
   }
 }
 
 template <int schedulerId>
 void CompactionBasedInputProcessor<schedulerId>::extractPublisherValues(
-    const std::vector<PublisherRow>& publisherRows) {
-  std::vector<bool> breakdownGroupIdShares(liftGameProcessedData_.numRows);
-  std::vector<bool> controlPopulationShares(liftGameProcessedData_.numRows);
-  std::vector<bool> isValidOpportunityTimestampShares(
-      liftGameProcessedData_.numRows);
-  std::vector<bool> testReachShares(liftGameProcessedData_.numRows);
-  std::vector<uint64_t> opportunityTimestampShares(
-      liftGameProcessedData_.numRows);
-
-  for (int row = 0; row < liftGameProcessedData_.numRows; row++) {
-    breakdownGroupIdShares[row] = publisherRows[row].breakdownId;
-    controlPopulationShares[row] = publisherRows[row].controlPopulation;
-    isValidOpportunityTimestampShares[row] =
-        publisherRows[row].isValidOpportunityTimestamp;
-    testReachShares[row] = publisherRows[row].testReach;
-    opportunityTimestampShares[row] = publisherRows[row].opportunityTimestamp;
-  }
-
-  breakdownGroupIds_ = SecBit<schedulerId>(
-      typename SecBit<schedulerId>::ExtractedBit(breakdownGroupIdShares));
-  controlPopulation_ = SecBit<schedulerId>(
-      typename SecBit<schedulerId>::ExtractedBit(controlPopulationShares));
+    CompactedColumns& compactedColumns) {
+  breakdownGroupIds_ =
+      SecBit<schedulerId>(typename SecBit<schedulerId>::ExtractedBit(
+          std::move(compactedColumns.breakdownId)));
+  controlPopulation_ =
+      SecBit<schedulerId>(typename SecBit<schedulerId>::ExtractedBit(
+          std::move(compactedColumns.controlPopulation)));
   liftGameProcessedData_.isValidOpportunityTimestamp =
       SecBit<schedulerId>(typename SecBit<schedulerId>::ExtractedBit(
-          isValidOpportunityTimestampShares));
-  liftGameProcessedData_.testReach = SecBit<schedulerId>(
-      typename SecBit<schedulerId>::ExtractedBit(testReachShares));
+          std::move(compactedColumns.isValidOpportunityTimestamp)));
+  liftGameProcessedData_.testReach =
+      SecBit<schedulerId>(typename SecBit<schedulerId>::ExtractedBit(
+          std::move(compactedColumns.testReach)));
   liftGameProcessedData_.opportunityTimestamps = SecTimestamp<schedulerId>(
       typename SecTimestamp<schedulerId>::ExtractedInt(
-          opportunityTimestampShares));
+          std::move(compactedColumns.opportunityTimestamp)));
 }
 } // namespace private_lift
@@ -14,6 +14,7 @@
 #include <functional>
 #include <string>
 
+#include "fbpcs/data_processing/common/Parsing.h"
 #include "fbpcs/emp_games/common/Csv.h"
 #include "fbpcs/emp_games/lift/pcf2_calculator/input_processing/InputData.h"
 
@@ -45,18 +46,16 @@ bool InputData::setTimestamps(
     std::vector<std::vector<uint32_t>>& timestampArrays) {
   timestampArrays.emplace_back();
   // Strip the brackets [] before splitting into individual timestamp values
-  auto innerString = str.substr(1, str.size() - 1);
+  auto innerString = str.substr(1, str.size() - 2);
   auto timestamps = private_measurement::csv::splitByComma(innerString, false);
 
   bool allZeroTimestamps = true;
   // Take up to numConversionsPerUser_ elements and ignore the rest
   for (std::size_t i = 0; i < timestamps.size() && i < numConversionsPerUser_;
        ++i) {
-    std::istringstream iss{timestamps[i]};
     int64_t parsed = 0;
-    iss >> parsed;
-    if (iss.fail()) {
-      LOG(FATAL) << "Failed to parse '" << iss.str() << "' to int64_t";
+    if (!parsing::tryParseInt(timestamps[i], parsed)) {
+      LOG(FATAL) << "Failed to parse '" << timestamps[i] << "' to int64_t";
     }
     // secret-share-lift can have negative input timestamps
     if (liftMpcType_ == LiftMPCType::Standard && parsed < epoch_ &&
@@ -76,16 +75,14 @@ void InputData::setValuesFields(std::string& str) {
     purchaseValueSquaredArrays_.emplace_back();
   }
   // Strip the brackets [] before splitting into individual values
-  auto innerString = str.substr(1, str.size() - 1);
+  auto innerString = str.substr(1, str.size() - 2);
   auto values = private_measurement::csv::splitByComma(innerString, false);
   // Take up to numConversionsPerUser_ elements and ignore the rest
   for (std::size_t i = 0; i < values.size() && i < numConversionsPerUser_;
        ++i) {
     int64_t parsed = 0;
-    std::istringstream iss{values[i]};
-    iss >> parsed;
-    if (iss.fail()) {
-      LOG(FATAL) << "Failed to parse '" << iss.str() << "' to int64_t";
+    if (!parsing::tryParseInt(values[i], parsed)) {
+      LOG(FATAL) << "Failed to parse '" << values[i] << "' to int64_t";
     }
     purchaseValueArrays_.back().push_back(parsed);
     totalValue_ += parsed;
@@ -132,14 +129,11 @@ void InputData::addFromCSV(
     auto column = header[i];
     auto value = parts[i];
     int64_t parsed = 0;
-    std::istringstream iss{value};
     // Array columns and features may be parsed differently
     if (!(column == "opportunity_timestamps" || column == "event_timestamps" ||
           column == "values" || column == "id_")) {
-      iss >> parsed;
-
-      if (iss.fail()) {
-        LOG(FATAL) << "Failed to parse '" << iss.str() << "' to int64_t";
+      if (!parsing::tryParseInt(value, parsed)) {
+        LOG(FATAL) << "Failed to parse '" << value << "' to int64_t";
       }
     }
 
@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "fbpcs/emp_games/common/Util.h"
 #include "fbpcs/emp_games/lift/pcf2_calculator/input_processing/LiftGameProcessedData.h"
 
 namespace private_lift {
@@ -232,12 +233,7 @@ template <int schedulerId>
 template <typename T>
 std::vector<std::vector<T>> LiftGameProcessedData<schedulerId>::transpose(
     const std::vector<std::vector<T>>& data) {
-  std::vector<std::vector<T>> result;
-  result.reserve(data[0].size());
-  for (size_t column = 0; column < data[0].size(); column++) {
-    result.push_back(extractColumn(data, column));
-  }
-  return result;
+  return common::transpose(data);
 }
 
 template <int schedulerId>
@@ -6,10 +6,12 @@
  */
 
 #include <filesystem>
+#include <fstream>
 #include <string>
 
 #include <gtest/gtest.h>
 
+#include "folly/Format.h"
 #include "folly/Random.h"
 
 #include "fbpcs/emp_games/lift/pcf2_calculator/input_processing/InputData.h"
@@ -222,4 +224,30 @@ TEST_F(InputDataTest, TestGetDummyRowsPartner) {
   auto resDummyRows1 = inputData1.getDummyRows();
   EXPECT_EQ(expectDummyRows1, resDummyRows1);
 }
+// Cells used to be read with a stream, which took the leading digits of
+// "12abc" or "10.5". They now have to be an integer as a whole.
+TEST_F(InputDataTest, TestInvalidIntegerCellFails) {
+  auto inputFilename = folly::sformat(
+      "{}/lift_invalid_input_{}.csv",
+      std::filesystem::temp_directory_path().native(),
+      folly::Random::secureRand64());
+  for (const auto& invalidValue : {"12abc", "10.5"}) {
+    {
+      std::ofstream inputFile{inputFilename};
+      inputFile << "id_,opportunity,test_flag,opportunity_timestamp\n"
+                << "cfcd208495d565ef66e7dff9f98764da,1,0,1600000430\n"
+                << "c4ca4238a0b923820dcc509a6f75849b,1,1," << invalidValue
+                << "\n";
+    }
+    EXPECT_DEATH(
+        (InputData{
+            inputFilename,
+            InputData::LiftMPCType::Standard,
+            true,
+            1546300800, /* epoch */
+            4 /* num_conversions_per_user */}),
+        folly::sformat("Failed to parse '{}' to int64_t", invalidValue));
+  }
+  std::filesystem::remove(inputFilename);
+}
 } // namespace private_lift
@@ -101,6 +101,10 @@ DEFINE_bool(
     compute_publisher_breakdowns,
     true,
     "To enable or disable computing publisher breakdown for result validation");
+DEFINE_bool(
+    compute_conv_histogram,
+    false,
+    "To enable or disable computing the test/control conversion histograms");
 DEFINE_string(
     pc_feature_flags,
     "",
@@ -215,6 +219,7 @@ int main(int argc, char** argv) {
             FLAGS_port,
             FLAGS_num_conversions_per_user,
             FLAGS_compute_publisher_breakdowns,
+            FLAGS_compute_conv_histogram,
             FLAGS_epoch,
             FLAGS_use_xor_encryption,
             tlsInfo);
@@ -232,6 +237,7 @@ int main(int argc, char** argv) {
             FLAGS_port,
             FLAGS_num_conversions_per_user,
             FLAGS_compute_publisher_breakdowns,
+            FLAGS_compute_conv_histogram,
             FLAGS_epoch,
             FLAGS_use_xor_encryption,
             tlsInfo);
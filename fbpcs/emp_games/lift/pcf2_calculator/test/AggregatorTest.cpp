@@ -35,7 +35,9 @@ Aggregator<schedulerId> createAggregatorWithScheduler(
   auto inputProcessor =
       InputProcessor<schedulerId>(myRole, inputData, numConversionsPerUser);
   auto attributor = std::make_unique<Attributor<schedulerId>>(
-      myRole, std::make_unique<InputProcessor<schedulerId>>(inputProcessor));
+      myRole,
+      std::make_unique<InputProcessor<schedulerId>>(inputProcessor),
+      true);
   return Aggregator<schedulerId>(
       myRole,
       std::make_unique<InputProcessor<schedulerId>>(std::move(inputProcessor)),
@@ -142,6 +144,31 @@ TEST_F(AggregatorTest, testConverters) {
   EXPECT_EQ(breakdown[1].controlConverters, 1);
 }
 
+TEST_F(AggregatorTest, testConvHistogram) {
+  auto test = publisherAggregator_->getMetrics().testConvHistogram;
+  auto control = publisherAggregator_->getMetrics().controlConvHistogram;
+  ASSERT_EQ(test.size(), 3);
+  ASSERT_EQ(control.size(), 3);
+  // Bins 1 and 2 must agree with the events and converters counts
+  EXPECT_EQ(test.at(1), 5);
+  EXPECT_EQ(test.at(2), 2);
+  EXPECT_EQ(control.at(1), 3);
+  EXPECT_EQ(control.at(2), 1);
+  auto cohort = publisherAggregator_->getCohortMetrics();
+  auto breakdown = publisherAggregator_->getBreakdownMetrics();
+  for (size_t bin = 0; bin < test.size(); ++bin) {
+    EXPECT_EQ(
+        cohort[0].testConvHistogram.at(bin) +
+            cohort[1].testConvHistogram.at(bin) +
+            cohort[2].testConvHistogram.at(bin),
+        test.at(bin));
+    EXPECT_EQ(
+        breakdown[0].controlConvHistogram.at(bin) +
+            breakdown[1].controlConvHistogram.at(bin),
+        control.at(bin));
+  }
+}
+
 TEST_F(AggregatorTest, testNumConvSquared) {
   auto test = publisherAggregator_->getMetrics().testNumConvSquared;
   EXPECT_EQ(test, 13);
@@ -32,7 +32,7 @@ Attributor<schedulerId> createAttributorWithScheduler(
       std::move(scheduler));
   auto inputProcessor = std::make_unique<InputProcessor<schedulerId>>(
       myRole, inputData, numConversionsPerUser);
-  return Attributor<schedulerId>(myRole, std::move(inputProcessor));
+  return Attributor<schedulerId>(myRole, std::move(inputProcessor), true);
 }
 
 class AttributorTest : public ::testing::Test {
@@ -152,6 +152,42 @@ TEST_F(AttributorTest, testNumConvSquared) {
   EXPECT_EQ(numConvSquared0, expectNumConvSquared);
 }
 
+template <int schedulerId>
+std::vector<std::vector<bool>> revealConvHistogram(
+    std::unique_ptr<Attributor<schedulerId>> attributor) {
+  std::vector<std::vector<bool>> output;
+  for (const auto& bin : attributor->getConvHistogram()) {
+    output.push_back(bin.openToParty(0).getValue());
+  }
+  return output;
+}
+
+TEST_F(AttributorTest, testConvHistogram) {
+  auto future0 =
+      std::async(revealConvHistogram<0>, std::move(publisherAttributor_));
+  auto future1 =
+      std::async(revealConvHistogram<1>, std::move(partnerAttributor_));
+  auto convHistogram0 = future0.get();
+  auto convHistogram1 = future1.get();
+  ASSERT_EQ(convHistogram0.size(), 3);
+  std::vector<bool> expectOneConversion = {
+      0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1,
+      1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1};
+  std::vector<bool> expectTwoConversions = {
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0};
+  EXPECT_EQ(convHistogram0.at(1), expectOneConversion);
+  EXPECT_EQ(convHistogram0.at(2), expectTwoConversions);
+  // Every row has exactly one bin set if it has a valid opportunity, and none
+  // otherwise, so the bins must be mutually exclusive
+  for (size_t row = 0; row < convHistogram0.at(0).size(); ++row) {
+    EXPECT_LE(
+        convHistogram0.at(0).at(row) + convHistogram0.at(1).at(row) +
+            convHistogram0.at(2).at(row),
+        1);
+  }
+}
+
 TEST_F(AttributorTest, testMatch) {
   auto future0 = std::async([&] {
     return publisherAttributor_->getMatch().openToParty(0).getValue();
@@ -11,6 +11,7 @@
 #include <fbpcf/scheduler/LazySchedulerFactory.h>
 #include <fbpcf/scheduler/NetworkPlaintextSchedulerFactory.h>
 #include "fbpcf/engine/communication/IPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/common/SchedulerStatistics.h"
 #include "fbpcs/emp_games/pcf2_aggregation/AggregationGame.h"
 #include "fbpcs/emp_games/pcf2_aggregation/AggregationOptions.h"
@@ -33,7 +34,8 @@ class AggregationApp {
       std::shared_ptr<fbpcf::util::MetricCollector> metricCollector,
       std::int32_t startFileIndex = 0,
       std::int32_t numFiles = 1,
-      int concurrency = 1)
+      int concurrency = 1,
+      std::shared_ptr<common::FileIndexQueue> fileIndexQueue = nullptr)
       : inputEncryption_(inputEncryption),
         outputVisibility_(outputVisibility),
         communicationAgentFactory_(std::move(communicationAgentFactory)),
@@ -45,6 +47,7 @@ class AggregationApp {
         startFileIndex_(startFileIndex),
         numFiles_(numFiles),
         concurrency_(concurrency),
+        fileIndexQueue_(std::move(fileIndexQueue)),
         schedulerStatistics_{0, 0, 0, 0} {}
 
   void run() {
@@ -56,15 +59,24 @@ class AggregationApp {
               MY_ROLE, *communicationAgentFactory_, metricCollector_)
               ->create();
 
+    // The file assigner agent is created before the game takes ownership of
+    // the communication agent factory
+    std::unique_ptr<common::FileAssigner> fileAssigner = nullptr;
+    if (fileIndexQueue_ != nullptr) {
+      fileAssigner = std::make_unique<common::FileAssigner>(
+          MY_ROLE,
+          fileIndexQueue_,
+          communicationAgentFactory_->create(
+              1 - MY_ROLE, "aggregation_file_assigner"));
+    }
+
     AggregationGame<schedulerId> game(
         std::move(scheduler),
         std::move(communicationAgentFactory_),
         inputEncryption_,
         concurrency_);
 
-    // Compute aggregations sequentially on numFiles files, starting from
-    // startFileIndex
-    for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+    auto computeFile = [&](size_t i) {
       CHECK_LT(i, inputSecretShareFilePaths_.size())
           << "File index exceeds number of files.";
       auto inputData = getInputData(
@@ -73,11 +85,27 @@ class AggregationApp {
           inputClearTextFilePaths_.at(i));
       AggregationOutputMetrics output;
       if (FLAGS_use_new_output_format) {
-        output = game.computeAggregationsReformatted(MY_ROLE, inputData);
+        output = game.computeAggregationsReformatted(
+            MY_ROLE, inputData, FLAGS_aggregate_rules_together);
       } else {
-        output = game.computeAggregations(MY_ROLE, inputData);
+        output = game.computeAggregations(
+            MY_ROLE, inputData, FLAGS_aggregate_rules_together);
       }
       putOutputData(output, outputFilePaths_.at(i));
+    };
+
+    if (fileAssigner != nullptr) {
+      // Keep the game alive and compute aggregations on whichever file is
+      // handed out next, until all files are done
+      while (auto i = fileAssigner->next()) {
+        computeFile(*i);
+      }
+    } else {
+      // Compute aggregations sequentially on numFiles files, starting from
+      // startFileIndex
+      for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+        computeFile(i);
+      }
     }
 
     auto gateStatistics =
@@ -130,7 +158,9 @@ class AggregationApp {
       const AggregationOutputMetrics& aggregationOutput,
       std::string outputPath) {
     fbpcf::io::FileIOWrappers::writeFile(
-        outputPath, aggregationOutput.toJson());
+        outputPath,
+        FLAGS_use_binary_output ? aggregationOutput.toBinary()
+                                : aggregationOutput.toJson());
   }
 
  private:
@@ -148,6 +178,7 @@ class AggregationApp {
   const std::int32_t startFileIndex_;
   const std::int32_t numFiles_;
   const int concurrency_;
+  std::shared_ptr<common::FileIndexQueue> fileIndexQueue_;
   common::SchedulerStatistics schedulerStatistics_;
 };
 
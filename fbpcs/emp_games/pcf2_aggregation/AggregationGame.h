@@ -89,13 +89,21 @@ class AggregationGame : public fbpcf::frontend::MpcGame<schedulerId> {
       std::vector<std::vector<TouchpointMetadata>>& touchpointMetadataArrays,
       std::vector<uint64_t>& validOriginalAdIds);
 
+  /**
+   * Aggregate the attribution results of every rule. With
+   * aggregateRulesTogether, the results of all rules are shared in one step
+   * and aggregated in a single ORAM indexed by (rule, ad id), so the ORAM
+   * passes and the reveal are not repeated per rule.
+   */
   AggregationOutputMetrics computeAggregations(
       const int myRole,
-      const AggregationInputMetrics& inputData);
+      const AggregationInputMetrics& inputData,
+      bool aggregateRulesTogether = false);
 
   AggregationOutputMetrics computeAggregationsReformatted(
       const int myRole,
-      const AggregationInputMetrics& inputData);
+      const AggregationInputMetrics& inputData,
+      bool aggregateRulesTogether = false);
 
  private:
   std::shared_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
@@ -9,6 +9,8 @@
 
 #include <fbpcs/emp_games/pcf2_aggregation/AggregationOptions.h>
 #include <fbpcs/emp_games/pcf2_aggregation/AttributionReformattedResult.h>
+#include <algorithm>
+#include <iterator>
 #include "fbpcf/engine/util/AesPrgFactory.h"
 #include "fbpcf/mpc_std_lib/oram/DifferenceCalculatorFactory.h"
 #include "fbpcf/mpc_std_lib/oram/LinearOramFactory.h"
@@ -168,7 +170,8 @@ AggregationGame<schedulerId>::shareAggregationFormats(
 template <int schedulerId>
 AggregationOutputMetrics AggregationGame<schedulerId>::computeAggregations(
     const int myRole,
-    const AggregationInputMetrics& inputData) {
+    const AggregationInputMetrics& inputData,
+    bool aggregateRulesTogether) {
   XLOG(INFO, "Running private aggregation");
 
   auto ids = inputData.getIds();
@@ -214,16 +217,25 @@ AggregationOutputMetrics AggregationGame<schedulerId>::computeAggregations(
       : fbpcf::mpc_std_lib::oram::IWriteOnlyOram<
             fbpcf::mpc_std_lib::util::AggregationValue>::Bob;
 
+  const auto& attributionRules = inputData.getAttributionRules();
+  if (attributionRules.empty()) {
+    // nothing to aggregate, both parties hold the same rules
+    XLOG(INFO, "No attribution rules to aggregate");
+    return AggregationOutputMetrics{};
+  }
+  // All rules share one ORAM indexed by (rule, ad id) when aggregated together
+  size_t numOramRules = aggregateRulesTogether ? attributionRules.size() : 1;
+
   PrivateAggregationMetrics<schedulerId> aggregationMetrics{
       aggregationFormats,
-      AggregationContext{validOriginalAdIds},
+      AggregationContext{validOriginalAdIds, numOramRules},
       myRole,
       concurrency_,
       // linear ORAM will be less efficient theoretically if ORAM size is
-      // larger than 4. Since ORAM size is adid size + 1, we use 3 as the
-      // threshold here.
+      // larger than 4. Since ORAM size is adid size + 1 for a single rule, we
+      // use 3 as the threshold here.
       std::move(
-          validOriginalAdIds.size() > 3
+          validOriginalAdIds.size() > 3 || numOramRules > 1
               ? fbpcf::mpc_std_lib::oram::getSecureWriteOnlyOramFactory<
                     fbpcf::mpc_std_lib::util::AggregationValue,
                     indicatorSumWidth,
@@ -234,9 +246,56 @@ AggregationOutputMetrics AggregationGame<schedulerId>::computeAggregations(
                     isPublisher, 0, 1, *communicationAgentFactory_))};
 
   AggregationOutputMetrics out;
-  const auto& attributionRules = inputData.getAttributionRules();
   const auto& attributionSecretShares = inputData.getAttributionSecretShares();
 
+  if (aggregateRulesTogether) {
+    // Share the attribution results of all rules in one step, then aggregate
+    // and reveal them in one pass
+    std::vector<std::vector<AttributionResult>> attributionResultsAllRules;
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      for (const auto& entries : attributionSecretShares.at(i)) {
+        std::vector<AttributionResult> results;
+        for (const auto& entry : entries) {
+          results.push_back(AttributionResult{entry.isAttributed});
+        }
+        attributionResultsAllRules.push_back(std::move(results));
+      }
+    }
+
+    XLOG(INFO, "Sharing attribution results of all rules...");
+    auto secretShareAllRules =
+        AggregationGame<schedulerId>::privatelyShareAttributionResults(
+            attributionResultsAllRules);
+
+    std::vector<PrivateAggregation<schedulerId>> privateAggregations;
+    auto ruleBegin = secretShareAllRules.begin();
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      auto ruleEnd = ruleBegin + attributionSecretShares.at(i).size();
+      privateAggregations.push_back(PrivateAggregation<schedulerId>{
+          std::vector<std::vector<PrivateAttributionResult<schedulerId>>>(
+              std::make_move_iterator(ruleBegin),
+              std::make_move_iterator(ruleEnd)),
+          privateTpmArrays,
+          privateCvmArrays});
+      ruleBegin = ruleEnd;
+    }
+
+    aggregationMetrics.computeAggregationsForRules(privateAggregations);
+
+    auto metricsPerRule =
+        aggregationMetrics.revealForRules(attributionRules.size());
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      out.ruleToMetrics[attributionRules.at(i)] =
+          std::move(metricsPerRule.at(i));
+    }
+    XLOGF(
+        INFO,
+        "Done computing aggregation for {} and {} rules.",
+        aggregationFormats.at(0).name,
+        attributionRules.size());
+    return out;
+  }
+
   for (size_t i = 0; i < attributionRules.size(); ++i) {
     // share secret shares computed for each attribution Rule
     std::vector<std::vector<AttributionResult>> attributionResultsPerRule;
@@ -276,7 +335,8 @@ template <int schedulerId>
 AggregationOutputMetrics
 AggregationGame<schedulerId>::computeAggregationsReformatted(
     const int myRole,
-    const AggregationInputMetrics& inputData) {
+    const AggregationInputMetrics& inputData,
+    bool aggregateRulesTogether) {
   XLOG(INFO, "Running private aggregation");
 
   auto ids = inputData.getIds();
@@ -300,16 +360,25 @@ AggregationGame<schedulerId>::computeAggregationsReformatted(
       : fbpcf::mpc_std_lib::oram::IWriteOnlyOram<
             fbpcf::mpc_std_lib::util::AggregationValue>::Bob;
 
+  const auto& attributionRules = inputData.getAttributionRules();
+  if (attributionRules.empty()) {
+    // nothing to aggregate, both parties hold the same rules
+    XLOG(INFO, "No attribution rules to aggregate");
+    return AggregationOutputMetrics{};
+  }
+  // All rules share one ORAM indexed by (rule, ad id) when aggregated together
+  size_t numOramRules = aggregateRulesTogether ? attributionRules.size() : 1;
+
   PrivateAggregationMetrics<schedulerId> aggregationMetrics{
       aggregationFormats,
-      AggregationContext{validOriginalAdIds},
+      AggregationContext{validOriginalAdIds, numOramRules},
       myRole,
       concurrency_,
       // linear ORAM will be less efficient theoretically if ORAM size is
-      // larger than 4. Since ORAM size is adid size + 1, we use 3 as the
-      // threshold here.
+      // larger than 4. Since ORAM size is adid size + 1 for a single rule, we
+      // use 3 as the threshold here.
       std::move(
-          validOriginalAdIds.size() > 3
+          validOriginalAdIds.size() > 3 || numOramRules > 1
               ? fbpcf::mpc_std_lib::oram::getSecureWriteOnlyOramFactory<
                     fbpcf::mpc_std_lib::util::AggregationValue,
                     indicatorSumWidth,
@@ -320,10 +389,62 @@ AggregationGame<schedulerId>::computeAggregationsReformatted(
                     isPublisher, 0, 1, *communicationAgentFactory_))};
 
   AggregationOutputMetrics out;
-  const auto& attributionRules = inputData.getAttributionRules();
   const auto& attributionReformattedSecretShares =
       inputData.getAttributionReformattedSecretShares();
 
+  if (aggregateRulesTogether) {
+    // Share the attribution results of all rules in one step, then aggregate
+    // and reveal them in one pass
+    std::vector<std::vector<AttributionReformattedResult>>
+        attributionReformattedResultsAllRules;
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      for (const auto& entries : attributionReformattedSecretShares.at(i)) {
+        std::vector<AttributionReformattedResult> results;
+        for (const auto& entry : entries) {
+          results.push_back(AttributionReformattedResult{
+              entry.adId, entry.convValue, entry.isAttributed});
+        }
+        attributionReformattedResultsAllRules.push_back(std::move(results));
+      }
+    }
+
+    XLOG(INFO, "Sharing reformatted attribution results of all rules...");
+    auto secretReformattedShareAllRules = AggregationGame<schedulerId>::
+        privatelyShareAttributionReformattedResults(
+            attributionReformattedResultsAllRules);
+
+    std::vector<PrivateAggregationReformatted<schedulerId>>
+        privateAggregationsReformatted;
+    auto ruleBegin = secretReformattedShareAllRules.begin();
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      auto ruleEnd =
+          ruleBegin + attributionReformattedSecretShares.at(i).size();
+      privateAggregationsReformatted.push_back(
+          PrivateAggregationReformatted<schedulerId>{
+              std::vector<std::vector<
+                  PrivateAttributionReformattedResult<schedulerId>>>(
+                  std::make_move_iterator(ruleBegin),
+                  std::make_move_iterator(ruleEnd))});
+      ruleBegin = ruleEnd;
+    }
+
+    aggregationMetrics.computeAggregationsReformattedForRules(
+        privateAggregationsReformatted);
+
+    auto metricsPerRule =
+        aggregationMetrics.revealForRules(attributionRules.size());
+    for (size_t i = 0; i < attributionRules.size(); ++i) {
+      out.ruleToMetrics[attributionRules.at(i)] =
+          std::move(metricsPerRule.at(i));
+    }
+    XLOGF(
+        INFO,
+        "Done computing aggregation for {} and {} rules.",
+        aggregationFormats.at(0).name,
+        attributionRules.size());
+    return out;
+  }
+
   for (size_t i = 0; i < attributionRules.size(); ++i) {
     // share secret shares computed for each attribution Rule
     std::vector<std::vector<AttributionReformattedResult>>
@@ -175,16 +175,11 @@ static const std::vector<ConversionMetadata> parseConversionMetadata(
   return convs;
 }
 
-AggregationInputMetrics::AggregationInputMetrics(
+void AggregationInputMetrics::readMetadata(
     int myRole,
     common::InputEncryption inputEncryption,
-    std::filesystem::path inputSecretShareFilePath,
-    std::filesystem::path inputClearTextFilePath,
-    std::string aggregationFormatNamesStr) {
-  XLOGF(
-      INFO,
-      "Reading attribution result file {}",
-      inputSecretShareFilePath.string());
+    const std::filesystem::path& inputClearTextFilePath,
+    const std::string& aggregationFormatNamesStr) {
   XLOGF(
       INFO, "Reading metadata input file {}", inputClearTextFilePath.string());
   XLOGF(
@@ -220,6 +215,20 @@ AggregationInputMetrics::AggregationInputMetrics(
         "Failed to read input metadata file {},",
         inputClearTextFilePath.string());
   }
+}
+
+AggregationInputMetrics::AggregationInputMetrics(
+    int myRole,
+    common::InputEncryption inputEncryption,
+    std::filesystem::path inputSecretShareFilePath,
+    std::filesystem::path inputClearTextFilePath,
+    std::string aggregationFormatNamesStr) {
+  XLOGF(
+      INFO,
+      "Reading attribution result file {}",
+      inputSecretShareFilePath.string());
+  readMetadata(
+      myRole, inputEncryption, inputClearTextFilePath, aggregationFormatNamesStr);
 
   XLOGF(
       INFO,
@@ -244,4 +253,21 @@ AggregationInputMetrics::AggregationInputMetrics(
   }
 }
 
+AggregationInputMetrics::AggregationInputMetrics(
+    int myRole,
+    common::InputEncryption inputEncryption,
+    std::filesystem::path inputClearTextFilePath,
+    std::string aggregationFormatNamesStr,
+    std::vector<std::string> attributionRules,
+    AggregationMetrics::AttributionResultsList attributionSecretShare,
+    AggregationMetrics::AttributionReformattedResultsList
+        attributionReformattedSecretShare)
+    : attributionRules_{std::move(attributionRules)},
+      attributionSecretShare_{std::move(attributionSecretShare)},
+      attributionReformattedSecretShare_{
+          std::move(attributionReformattedSecretShare)} {
+  readMetadata(
+      myRole, inputEncryption, inputClearTextFilePath, aggregationFormatNamesStr);
+}
+
 } // namespace pcf2_aggregation
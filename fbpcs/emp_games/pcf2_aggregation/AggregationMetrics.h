@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "fbpcs/emp_games/common/Csv.h"
+#include "fbpcs/emp_games/common/MetricsBinaryFormat.h"
 
 #include "fbpcs/emp_games/pcf2_aggregation/Aggregator.h"
 #include "fbpcs/emp_games/pcf2_aggregation/AttributionReformattedResult.h"
@@ -182,6 +183,27 @@ struct AggregationOutputMetrics {
     auto obj = folly::parseJson(str);
     return fromDynamic(std::move(obj));
   }
+
+  // Same tree as toJson() in the binary metrics format (see
+  // common/MetricsBinaryFormat.h), written without building the outer
+  // folly::dynamic levels.
+  std::string toBinary() const {
+    common::MetricsBinaryWriter writer;
+    writer.beginDict(ruleToMetrics.size());
+    for (const auto& [rule, metrics] : ruleToMetrics) {
+      writer.writeKey(rule);
+      writer.beginDict(metrics.formatToAggregation.size());
+      for (const auto& [format, aggregation] : metrics.formatToAggregation) {
+        writer.writeKey(format);
+        common::writeMetricsBinary(writer, aggregation);
+      }
+    }
+    return writer.finish();
+  }
+
+  static AggregationOutputMetrics fromBinary(const std::string& str) {
+    return fromDynamic(common::metricsBinaryToDynamic(str));
+  }
 };
 
 /*
@@ -197,6 +219,21 @@ class AggregationInputMetrics {
       std::filesystem::path inputClearTextFilePaths,
       std::string aggregationFormatName);
 
+  /**
+   * Reads only the clear text metadata file, the attribution results of
+   * attributionRules are handed over as already secret shared values, e.g.
+   * straight from an attribution game in the same process.
+   */
+  explicit AggregationInputMetrics(
+      int myRole,
+      common::InputEncryption inputEncryption,
+      std::filesystem::path inputClearTextFilePath,
+      std::string aggregationFormatNamesStr,
+      std::vector<std::string> attributionRules,
+      AggregationMetrics::AttributionResultsList attributionSecretShare,
+      AggregationMetrics::AttributionReformattedResultsList
+          attributionReformattedSecretShare);
+
   explicit AggregationInputMetrics(
       std::vector<int64_t> ids,
       std::vector<std::string> attributionRules,
@@ -247,6 +284,13 @@ class AggregationInputMetrics {
   }
 
  private:
+  // Parses the aggregation formats and the touchpoint and conversion metadata
+  void readMetadata(
+      int myRole,
+      common::InputEncryption inputEncryption,
+      const std::filesystem::path& inputClearTextFilePath,
+      const std::string& aggregationFormatNamesStr);
+
   std::vector<int64_t> ids_;
   std::vector<std::string> attributionRules_;
   std::vector<std::string> aggregationFormats_;
@@ -300,6 +344,40 @@ class PrivateAggregationMetrics {
     return out;
   }
 
+  // The *ForRules methods aggregate all attribution rules side by side and
+  // require the metrics to be created with a context for that many rules.
+  void computeAggregationsForRules(
+      const std::vector<PrivateAggregation<schedulerId>>& privateAggregations) {
+    for (const auto& [format, aggregator] : formatToAggregator) {
+      aggregator->aggregateAttributionsForRules(privateAggregations);
+    }
+  }
+
+  void computeAggregationsReformattedForRules(
+      const std::vector<PrivateAggregationReformatted<schedulerId>>&
+          privateAggregationsReformatted) {
+    for (const auto& [format, aggregator] : formatToAggregator) {
+      aggregator->aggregateReformattedAttributionsForRules(
+          privateAggregationsReformatted);
+    }
+  }
+
+  // Returns the metrics of every rule, in rule order
+  std::vector<AggregationMetrics> revealForRules(size_t numAttributionRules) {
+    std::vector<AggregationMetrics> out(numAttributionRules);
+
+    for (const auto& [format, aggregator] : formatToAggregator) {
+      auto outputs = aggregator->revealForRules();
+      CHECK_EQ(outputs.size(), numAttributionRules)
+          << "Aggregator was not created for this number of attribution rules.";
+      for (size_t rule = 0; rule < numAttributionRules; ++rule) {
+        out.at(rule).formatToAggregation[format] = std::move(outputs.at(rule));
+      }
+    }
+
+    return out;
+  }
+
  private:
   std::unordered_map<std::string, std::unique_ptr<Aggregator<schedulerId>>>
       formatToAggregator;
@@ -70,6 +70,16 @@ DEFINE_string(
     ".s3.us-west-2.amazonaws.com/",
     "s3 region name");
 DEFINE_bool(use_new_output_format, false, "New Format of Attribution output");
+DEFINE_bool(
+    aggregate_rules_together,
+    false,
+    "Aggregate all attribution rules in one ORAM instead of one rule at a "
+    "time");
+DEFINE_bool(
+    use_binary_output,
+    false,
+    "Write the aggregation output in the binary metrics format read by the "
+    "shard combiner instead of JSON");
 DEFINE_string(
     run_id,
     "",
@@ -30,6 +30,8 @@ DECLARE_bool(log_cost);
 DECLARE_string(log_cost_s3_bucket);
 DECLARE_string(log_cost_s3_region);
 DECLARE_bool(use_new_output_format);
+DECLARE_bool(aggregate_rules_together);
+DECLARE_bool(use_binary_output);
 DECLARE_string(run_id);
 DECLARE_string(pc_feature_flags);
 DECLARE_bool(use_tls);
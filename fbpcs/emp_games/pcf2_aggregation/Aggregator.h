@@ -86,10 +86,25 @@ class Aggregator {
           privateAggregationReformatted) = 0;
 
   virtual AggregationOutput reveal() const = 0;
+
+  // Aggregates the attributions of all rules at once, the i-th entry being
+  // aggregated for rule i. Requires an aggregator created for that many rules.
+  virtual void aggregateAttributionsForRules(
+      const std::vector<PrivateAggregation<schedulerId>>&
+          privateAggregations) = 0;
+
+  virtual void aggregateReformattedAttributionsForRules(
+      const std::vector<PrivateAggregationReformatted<schedulerId>>&
+          privateAggregationsReformatted) = 0;
+
+  // Reveals the aggregation of every rule, in rule order
+  virtual std::vector<AggregationOutput> revealForRules() const = 0;
 };
 
 struct AggregationContext {
   const std::vector<uint64_t>& validOriginalAdIds;
+  // number of attribution rules aggregated side by side by one aggregator
+  size_t numAttributionRules = 1;
 };
 
 template <int schedulerId>
@@ -53,20 +53,46 @@ struct MeasurementAggregation {
 template <int schedulerId>
 class MeasurementAggregator : public Aggregator<schedulerId> {
  public:
+  // touchpoint-conversion pairs, per id
+  using TouchpointConversionResults =
+      std::vector<std::vector<typename MeasurementAggregation<
+          schedulerId>::PrivateMeasurementAggregationResult>>;
+
   explicit MeasurementAggregator(
       const std::vector<uint64_t>& validOriginalAdIds,
       const int myRole,
       const int concurrency,
       std::unique_ptr<fbpcf::mpc_std_lib::oram::IWriteOnlyOramFactory<
-          fbpcf::mpc_std_lib::util::AggregationValue>> writeOnlyOramFactory)
+          fbpcf::mpc_std_lib::util::AggregationValue>> writeOnlyOramFactory,
+      size_t numAttributionRules = 1)
       : Aggregator<schedulerId>{} {
     _validOriginalAdIds = validOriginalAdIds;
-    size_t oramSize = _validOriginalAdIds.size() + 1;
+    CHECK_GT(numAttributionRules, 0)
+        << "Number of attribution rules must be greater than zero.";
+    _numAttributionRules = numAttributionRules;
+    // The ORAM index of (rule, adId) holds the adId in its low bits and the
+    // rule in the bits above. The rule is public, so the index shares of an
+    // entry are its ad id shares followed by fixed shares of the rule, and no
+    // secret addition is needed. With a single rule the index is the ad id.
+    _adIdIndexWidth = std::ceil(std::log2(_validOriginalAdIds.size() + 1));
+    _ruleStride = size_t{1} << _adIdIndexWidth;
+    size_t oramSize = (_numAttributionRules - 1) * _ruleStride +
+        _validOriginalAdIds.size() + 1;
     // Note that oramSize must be nonzero because
     // we will be taking its logarithm.
     CHECK_GT(oramSize, 0) << "ORAM size must be greater than zero.";
-    _oramWidth =
-        std::ceil(std::log2(oramSize)); // number of bits used to store the adId
+    // number of bits used to store the index
+    _oramWidth = std::ceil(std::log2(oramSize));
+    for (size_t rule = 0; rule < _numAttributionRules; ++rule) {
+      std::vector<bool> ruleShares;
+      for (size_t i = _adIdIndexWidth; i < _oramWidth; ++i) {
+        SecBit<schedulerId> ruleBit(
+            static_cast<bool>((rule >> (i - _adIdIndexWidth)) & 1),
+            common::PUBLISHER);
+        ruleShares.push_back(ruleBit.extractBit().getValue());
+      }
+      _ruleIndexShares.push_back(std::move(ruleShares));
+    }
     _writeOnlyOram = writeOnlyOramFactory->create(oramSize);
     _oramMaxBatchSize =
         writeOnlyOramFactory->getMaxBatchSize(oramSize, concurrency);
@@ -92,9 +118,7 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     CHECK_EQ(privateCvmArrays.size(), privateTpmArrays.size())
         << "Size of conversion metadata and touchpoint metadata should be equal.";
 
-    std::vector<std::vector<typename MeasurementAggregation<
-        schedulerId>::PrivateMeasurementAggregationResult>>
-        touchpointConversionResults;
+    TouchpointConversionResults touchpointConversionResults;
     for (size_t i = 0; i < privateCvmArrays.size(); ++i) {
       // Retrieve the touchpoint-conversion metadata pairs based on
       // attribution results.
@@ -112,6 +136,42 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     aggregateUsingOram(touchpointConversionResults);
   }
 
+  virtual void aggregateAttributionsForRules(
+      const std::vector<PrivateAggregation<schedulerId>>& privateAggregations)
+      override {
+    CHECK_EQ(privateAggregations.size(), _numAttributionRules)
+        << "Aggregator was not created for this number of attribution rules.";
+    TouchpointConversionResults touchpointConversionResults;
+    std::vector<size_t> ruleIndices;
+    for (size_t rule = 0; rule < privateAggregations.size(); ++rule) {
+      const auto& privateAggregation = privateAggregations.at(rule);
+      CHECK_EQ(
+          privateAggregation.attributionResults.size(),
+          privateAggregation.privateTpm.size())
+          << "Size of attribution results and touchpoint metadata should be equal.";
+      CHECK_EQ(
+          privateAggregation.privateCvm.size(),
+          privateAggregation.privateTpm.size())
+          << "Size of conversion metadata and touchpoint metadata should be equal.";
+      for (size_t i = 0; i < privateAggregation.privateCvm.size(); ++i) {
+        touchpointConversionResults.push_back(
+            retrieveTouchpointForConversionPerID(
+                privateAggregation.privateTpm.at(i),
+                privateAggregation.privateCvm.at(i),
+                privateAggregation.attributionResults.at(i)));
+        ruleIndices.push_back(rule);
+      }
+    }
+
+    XLOGF(
+        INFO,
+        "Retrieved touchpoint-conversion metadata for {} rules",
+        privateAggregations.size());
+
+    // One ORAM pass for all rules
+    aggregateUsingOram(touchpointConversionResults, ruleIndices);
+  }
+
   virtual void aggregateReformattedAttributions(
       const PrivateAggregationReformatted<schedulerId>&
           privateAggregationReformatted) override {
@@ -125,9 +185,7 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
         "For measurement aggregator, size of reformatted attribution: {}",
         privateAttributionReformattedArrays.size());
 
-    std::vector<std::vector<typename MeasurementAggregation<
-        schedulerId>::PrivateMeasurementAggregationResult>>
-        touchpointConversionResults;
+    TouchpointConversionResults touchpointConversionResults;
     for (size_t i = 0; i < privateAttributionReformattedArrays.size(); ++i) {
       // Retrieve the touchpoint-conversion metadata pairs based on
       // attribution results.
@@ -143,6 +201,34 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     aggregateUsingOram(touchpointConversionResults);
   }
 
+  virtual void aggregateReformattedAttributionsForRules(
+      const std::vector<PrivateAggregationReformatted<schedulerId>>&
+          privateAggregationsReformatted) override {
+    CHECK_EQ(privateAggregationsReformatted.size(), _numAttributionRules)
+        << "Aggregator was not created for this number of attribution rules.";
+    TouchpointConversionResults touchpointConversionResults;
+    std::vector<size_t> ruleIndices;
+    for (size_t rule = 0; rule < privateAggregationsReformatted.size();
+         ++rule) {
+      for (const auto& attributionReformattedResults :
+           privateAggregationsReformatted.at(rule)
+               .attributionReformattedResults) {
+        touchpointConversionResults.push_back(
+            retrieveTouchpointForConversionPerIDReformatted(
+                attributionReformattedResults));
+        ruleIndices.push_back(rule);
+      }
+    }
+
+    XLOGF(
+        INFO,
+        "Retrieved touchpoint-conversion metadata for {} rules",
+        privateAggregationsReformatted.size());
+
+    // One ORAM pass for all rules
+    aggregateUsingOram(touchpointConversionResults, ruleIndices);
+  }
+
   const std::vector<typename MeasurementAggregation<
       schedulerId>::PrivateMeasurementAggregationResult>
   retrieveTouchpointForConversionPerID(
@@ -220,10 +306,11 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     return aggregationResults;
   }
 
+  // ruleIndices[i] is the attribution rule of touchpointConversionResults[i].
+  // If it is empty, all entries belong to rule 0.
   void aggregateUsingOram(
-      const std::vector<std::vector<typename MeasurementAggregation<
-          schedulerId>::PrivateMeasurementAggregationResult>>&
-          touchpointConversionResults) {
+      const TouchpointConversionResults& touchpointConversionResults,
+      const std::vector<size_t>& ruleIndices = {}) {
     size_t startIndex = 0;
     while (startIndex < touchpointConversionResults.size()) {
       size_t endIndex = std::min(
@@ -233,8 +320,8 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
           "ORAM batch startIndex = {}, endIndex = {}",
           startIndex,
           endIndex);
-      auto oramInput =
-          generateOramInput(touchpointConversionResults, startIndex, endIndex);
+      auto oramInput = generateOramInput(
+          touchpointConversionResults, ruleIndices, startIndex, endIndex);
       _writeOnlyOram->obliviousAddBatch(oramInput.first, oramInput.second);
       startIndex = endIndex;
     }
@@ -247,9 +334,8 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
   const std::
       pair<std::vector<std::vector<bool>>, std::vector<std::vector<bool>>>
       generateOramInput(
-          const std::vector<std::vector<typename MeasurementAggregation<
-              schedulerId>::PrivateMeasurementAggregationResult>>&
-              touchpointConversionResults,
+          const TouchpointConversionResults& touchpointConversionResults,
+          const std::vector<size_t>& ruleIndices,
           const size_t startIndex,
           const size_t endIndex) {
     std::vector<std::vector<bool>> indexShares(_oramWidth, std::vector<bool>{});
@@ -261,17 +347,22 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     CHECK_LE(endIndex, touchpointConversionResults.size())
         << "ORAM endIndex must be at most size of array";
     for (size_t index = startIndex; index < endIndex; ++index) {
+      const auto& ruleShares = _ruleIndexShares.at(
+          ruleIndices.empty() ? 0 : ruleIndices.at(index));
       for (auto& touchpointConversionResult :
            touchpointConversionResults.at(index)) {
         const auto& touchpoint =
             touchpointConversionResult.measurementTouchpointMetadata;
         const auto& conversion =
             touchpointConversionResult.measurementConversionMetadata;
-        // Retrieve adId shares
+        // Retrieve adId shares, followed by the attribution rule shares
         auto indexShare = touchpoint.adId.extractIntShare().getBooleanShares();
-        for (size_t i = 0; i < _oramWidth; ++i) {
+        for (size_t i = 0; i < _adIdIndexWidth; ++i) {
           indexShares.at(i).push_back(indexShare.at(i));
         }
+        for (size_t i = _adIdIndexWidth; i < _oramWidth; ++i) {
+          indexShares.at(i).push_back(ruleShares.at(i - _adIdIndexWidth));
+        }
         // Retrieve conversion value share if attributed, or zero if not
         // attributed
         const PubSalesValue<schedulerId> one(uint32_t(1));
@@ -295,12 +386,26 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
   }
 
   virtual AggregationOutput reveal() const override {
+    return revealRule(0);
+  }
+
+  virtual std::vector<AggregationOutput> revealForRules() const override {
+    std::vector<AggregationOutput> out;
+    for (size_t rule = 0; rule < _numAttributionRules; ++rule) {
+      out.push_back(revealRule(rule));
+    }
+    return out;
+  }
+
+ private:
+  AggregationOutput revealRule(size_t rule) const {
     MeasurementAggregation<schedulerId> out;
     for (size_t i = 1; i < _validOriginalAdIds.size() + 1; ++i) {
       const auto rAdId = _validOriginalAdIds.at(i - 1);
       XLOGF(DBG, "Revealing measurement metrics for adId={}", rAdId);
       fbpcf::mpc_std_lib::util::AggregationValue aggregationValue;
-      auto additiveAggregationValue = _writeOnlyOram->secretRead(i);
+      auto additiveAggregationValue =
+          _writeOnlyOram->secretRead(rule * _ruleStride + i);
 
       // Convert additive shares to secret shares by inputting them into MPC
       // and adding them, then extracting the secret shares.
@@ -325,8 +430,12 @@ class MeasurementAggregator : public Aggregator<schedulerId> {
     return out.toDynamic();
   }
 
- private:
   std::vector<uint64_t> _validOriginalAdIds;
+  size_t _numAttributionRules;
+  uint8_t _adIdIndexWidth;
+  size_t _ruleStride;
+  // shares of the rule bits of the ORAM index, per attribution rule
+  std::vector<std::vector<bool>> _ruleIndexShares;
   std::unique_ptr<fbpcf::mpc_std_lib::oram::IWriteOnlyOram<
       fbpcf::mpc_std_lib::util::AggregationValue>>
       _writeOnlyOram;
@@ -352,7 +461,8 @@ static const std::vector<AggregationFormat<schedulerId>>
               ctx.validOriginalAdIds,
               myRole,
               concurrency,
-              std::move(writeOnlyOramFactory));
+              std::move(writeOnlyOramFactory),
+              ctx.numAttributionRules);
         }}};
 
 template <int schedulerId>
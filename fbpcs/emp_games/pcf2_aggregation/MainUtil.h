@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "fbpcf/engine/communication/SocketPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/pcf2_aggregation/AggregationApp.h"
 
 namespace pcf2_aggregation {
@@ -47,7 +48,7 @@ template <int PARTY, int index>
 inline common::SchedulerStatistics startAggregationAppsForShardedFilesHelper(
     common::InputEncryption inputEncryption,
     common::Visibility outputVisibility,
-    int startFileIndex,
+    std::shared_ptr<common::FileIndexQueue> fileIndexQueue,
     int remainingThreads,
     int numThreads,
     std::string serverIp,
@@ -62,15 +63,7 @@ inline common::SchedulerStatistics startAggregationAppsForShardedFilesHelper(
   common::SchedulerStatistics schedulerStatistics{
       0, 0, 0, 0, folly::dynamic::object()};
 
-  // split files evenly across threads
-  auto remainingFiles =
-      static_cast<std::int64_t>(inputSecretShareFilenames.size()) -
-      startFileIndex;
-  if (remainingFiles > 0) {
-    auto numFiles = (remainingThreads > remainingFiles)
-        ? 1
-        : (remainingFiles / remainingThreads);
-
+  if (remainingThreads > 0) {
     std::map<
         int,
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory::
@@ -86,7 +79,8 @@ inline common::SchedulerStatistics startAggregationAppsForShardedFilesHelper(
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory>(
         PARTY, partyInfos, tlsInfo, metricCollector);
 
-    // Each AggregationApp runs numFiles sequentially on a single thread
+    // Each AggregationApp keeps its scheduler on a single thread and takes
+    // files from the shared queue until all files are done.
     // Publisher uses even schedulerId and partner uses odd schedulerId
     auto app = std::make_unique<
         pcf2_aggregation::AggregationApp<PARTY, 2 * index + PARTY>>(
@@ -98,9 +92,10 @@ inline common::SchedulerStatistics startAggregationAppsForShardedFilesHelper(
         inputClearTextFilenames,
         outputFilenames,
         metricCollector,
-        startFileIndex,
-        numFiles,
-        numThreads);
+        0,
+        0,
+        numThreads,
+        fileIndexQueue);
 
     auto future = std::async([&app]() {
       app->run();
@@ -113,7 +108,7 @@ inline common::SchedulerStatistics startAggregationAppsForShardedFilesHelper(
             startAggregationAppsForShardedFilesHelper<PARTY, index + 1>(
                 inputEncryption,
                 outputVisibility,
-                startFileIndex + numFiles,
+                fileIndexQueue,
                 remainingThreads - 1,
                 numThreads,
                 serverIp,
@@ -152,7 +147,8 @@ inline common::SchedulerStatistics startAggregationAppsForShardedFiles(
   return startAggregationAppsForShardedFilesHelper<PARTY, 0>(
       inputEncryption,
       outputVisibility,
-      0,
+      std::make_shared<common::FileIndexQueue>(
+          inputSecretShareFilenames.size()),
       numThreads,
       numThreads,
       serverIp,
@@ -22,6 +22,7 @@
 #include "fbpcf/engine/communication/test/TlsCommunicationUtils.h"
 #include "fbpcf/util/MetricCollector.h"
 #include "fbpcs/emp_games/common/Constants.h"
+#include "fbpcs/emp_games/common/MetricsBinaryFormat.h"
 #include "fbpcs/emp_games/common/TestUtil.h"
 #include "fbpcs/emp_games/common/test/TestUtils.h"
 #include "fbpcs/emp_games/pcf2_aggregation/AggregationApp.h"
@@ -133,10 +134,14 @@ inline void testCorrectnessAggregationAppHelper(
   futureAlice.get();
   futureBob.get();
 
-  auto resAlice = AggregationOutputMetrics::fromJson(
-      fbpcf::io::FileIOWrappers::readFile(outputPathAlice.at(id)));
-  auto resBob = AggregationOutputMetrics::fromJson(
-      fbpcf::io::FileIOWrappers::readFile(outputPathBob.at(id)));
+  auto readOutput = [](const std::string& outputPath) {
+    auto output = fbpcf::io::FileIOWrappers::readFile(outputPath);
+    return common::isMetricsBinary(output)
+        ? AggregationOutputMetrics::fromBinary(output)
+        : AggregationOutputMetrics::fromJson(output);
+  };
+  auto resAlice = readOutput(outputPathAlice.at(id));
+  auto resBob = readOutput(outputPathBob.at(id));
 
   if constexpr (outputVisibility == common::Visibility::Xor) {
     auto result = revealXORedResult(
@@ -314,6 +319,27 @@ TEST_P(AggregationAppTest, TestCorrectness) {
   }
 }
 
+TEST_P(AggregationAppTest, TestCorrectnessBinaryOutput) {
+  auto [id, visibility, useTls, useNewOutputFormat] = GetParam();
+  // the output format does not depend on the data set or the channel
+  if (id != 0 || useTls) {
+    GTEST_SKIP();
+  }
+  FLAGS_use_new_output_format = useNewOutputFormat;
+  FLAGS_use_binary_output = true;
+  switch (visibility) {
+    case common::Visibility::Publisher:
+      testCorrectnessAggregationAppWrapper<0, common::Visibility::Publisher>(
+          useTls, useNewOutputFormat);
+      break;
+    case common::Visibility::Xor:
+      testCorrectnessAggregationAppWrapper<0, common::Visibility::Xor>(
+          useTls, useNewOutputFormat);
+      break;
+  }
+  FLAGS_use_binary_output = false;
+}
+
 // Test cases are iterate in https://fb.quip.com/IUHDApxKEAli
 INSTANTIATE_TEST_SUITE_P(
     AggregationAppTest,
@@ -8,6 +8,8 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <fbpcs/emp_games/pcf2_aggregation/AttributionReformattedResult.h>
 #include "folly/test/JsonTestUtil.h"
@@ -454,11 +456,12 @@ AggregationOutputMetrics computeAggregationsWithScheduler(
     common::InputEncryption inputEncryption,
     std::shared_ptr<
         fbpcf::engine::communication::IPartyCommunicationAgentFactory> factory,
-    fbpcf::SchedulerCreator schedulerCreator) {
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool aggregateRulesTogether = false) {
   auto scheduler = schedulerCreator(myId, *factory);
   auto game = std::make_unique<AggregationGame<schedulerId>>(
       std::move(scheduler), std::move(factory), inputEncryption);
-  return game->computeAggregations(myId, inputData);
+  return game->computeAggregations(myId, inputData, aggregateRulesTogether);
 }
 
 template <int schedulerId>
@@ -468,17 +471,20 @@ AggregationOutputMetrics computeAggregationsReformattedWithScheduler(
     common::InputEncryption inputEncryption,
     std::shared_ptr<
         fbpcf::engine::communication::IPartyCommunicationAgentFactory> factory,
-    fbpcf::SchedulerCreator schedulerCreator) {
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool aggregateRulesTogether = false) {
   auto scheduler = schedulerCreator(myId, *factory);
   auto game = std::make_unique<AggregationGame<schedulerId>>(
       std::move(scheduler), std::move(factory), inputEncryption);
-  return game->computeAggregationsReformatted(myId, inputData);
+  return game->computeAggregationsReformatted(
+      myId, inputData, aggregateRulesTogether);
 }
 
 // Test cases are from https://fb.quip.com/IUHDApxKEAli
 void testCorrectnessWithScheduler(
     common::InputEncryption inputEncryption,
-    fbpcf::SchedulerCreator schedulerCreator) {
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool aggregateRulesTogether = false) {
   std::string baseDir_ =
       private_measurement::test_util::getBaseDirFromPath(__FILE__);
   // Attribution rules to test
@@ -533,7 +539,8 @@ void testCorrectnessWithScheduler(
           publisherInputData,
           inputEncryption,
           std::move(factories[0]),
-          schedulerCreator);
+          schedulerCreator,
+          aggregateRulesTogether);
 
       auto future1 = std::async(
           computeAggregationsWithScheduler<1>,
@@ -541,7 +548,8 @@ void testCorrectnessWithScheduler(
           partnerInputData,
           inputEncryption,
           std::move(factories[1]),
-          schedulerCreator);
+          schedulerCreator,
+          aggregateRulesTogether);
 
       auto res0 = future0.get();
       auto res1 = future1.get();
@@ -556,7 +564,8 @@ void testCorrectnessWithScheduler(
 
 void testCorrectnessReformattedWithScheduler(
     common::InputEncryption inputEncryption,
-    fbpcf::SchedulerCreator schedulerCreator) {
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool aggregateRulesTogether = false) {
   FLAGS_use_new_output_format = true;
   std::string baseDir_ =
       private_measurement::test_util::getBaseDirFromPath(__FILE__);
@@ -614,7 +623,8 @@ void testCorrectnessReformattedWithScheduler(
           publisherInputData,
           inputEncryption,
           std::move(factories[0]),
-          schedulerCreator);
+          schedulerCreator,
+          aggregateRulesTogether);
 
       auto future1 = std::async(
           computeAggregationsReformattedWithScheduler<1>,
@@ -622,7 +632,8 @@ void testCorrectnessReformattedWithScheduler(
           partnerInputData,
           inputEncryption,
           std::move(factories[1]),
-          schedulerCreator);
+          schedulerCreator,
+          aggregateRulesTogether);
 
       auto res0 = future0.get();
       auto res1 = future1.get();
@@ -635,6 +646,220 @@ void testCorrectnessReformattedWithScheduler(
   }
 }
 
+// Rules of the synthetic multi rule inputs, the attribution results of a rule
+// depend on its index in this list.
+const std::vector<std::string> kMultiRuleNames{
+    common::LAST_CLICK_1D,
+    common::LAST_TOUCH_1D,
+    common::LAST_CLICK_2_7D};
+
+// Builds the inputs of myRole for the rules at the given indices of
+// kMultiRuleNames, with touchpoints on numAdIds distinct ad ids. The publisher
+// holds the touchpoints and the attribution results and the partner the
+// conversion values, the other party's shares are all zero.
+AggregationInputMetrics makeMultiRuleInput(
+    int myRole,
+    common::InputEncryption inputEncryption,
+    uint64_t numAdIds,
+    const std::vector<size_t>& rules) {
+  const size_t numIds = 6;
+  const size_t numTouchpoints = FLAGS_max_num_touchpoints;
+  const size_t numConversions = FLAGS_max_num_conversions;
+  bool isPublisher = (myRole == common::PUBLISHER);
+
+  std::vector<int64_t> ids;
+  std::vector<std::vector<TouchpointMetadata>> tpmArrays;
+  std::vector<std::vector<ConversionMetadata>> cvmArrays;
+  for (size_t id = 0; id < numIds; ++id) {
+    ids.push_back(id);
+    std::vector<TouchpointMetadata> tpms;
+    for (size_t tp = 0; tp < numTouchpoints; ++tp) {
+      // the last touchpoint of every id is padding
+      uint64_t originalAdId = (isPublisher && tp + 1 < numTouchpoints)
+          ? 100 * ((id + tp) % numAdIds + 1)
+          : 0;
+      tpms.push_back(TouchpointMetadata{originalAdId, 0, false, 0, 0});
+    }
+    tpmArrays.push_back(std::move(tpms));
+
+    std::vector<ConversionMetadata> cvms;
+    for (size_t conv = 0; conv < numConversions; ++conv) {
+      uint32_t convValue = (!isPublisher && conv + 1 < numConversions)
+          ? 10 * (id + 1) + conv
+          : 0;
+      cvms.push_back(ConversionMetadata{0, convValue, 0, inputEncryption});
+    }
+    cvmArrays.push_back(std::move(cvms));
+  }
+
+  std::vector<std::string> attributionRules;
+  AggregationMetrics::AttributionResultsList attributionResults;
+  AggregationMetrics::AttributionReformattedResultsList
+      attributionReformattedResults;
+  for (auto rule : rules) {
+    attributionRules.push_back(kMultiRuleNames.at(rule));
+    std::vector<std::vector<AttributionResult>> ruleResults;
+    std::vector<std::vector<AttributionReformattedResult>>
+        ruleReformattedResults;
+    for (size_t id = 0; id < numIds; ++id) {
+      std::vector<AttributionResult> results;
+      for (size_t i = 0; i < numTouchpoints * numConversions; ++i) {
+        results.push_back(
+            AttributionResult{isPublisher && (id + i + rule) % 3 == 0});
+      }
+      ruleResults.push_back(std::move(results));
+
+      std::vector<AttributionReformattedResult> reformattedResults;
+      for (size_t conv = 0; conv < numConversions; ++conv) {
+        if (isPublisher) {
+          reformattedResults.push_back(AttributionReformattedResult{
+              (id + 2 * conv + rule) % (numAdIds + 1),
+              10 * (id + 1) + conv,
+              (id + conv + rule) % 3 != 0});
+        } else {
+          reformattedResults.push_back(
+              AttributionReformattedResult{0, 0, false});
+        }
+      }
+      ruleReformattedResults.push_back(std::move(reformattedResults));
+    }
+    attributionResults.push_back(std::move(ruleResults));
+    attributionReformattedResults.push_back(std::move(ruleReformattedResults));
+  }
+
+  std::vector<std::string> aggregationFormats;
+  if (isPublisher) {
+    aggregationFormats.push_back(common::MEASUREMENT);
+  }
+  return AggregationInputMetrics{
+      std::move(ids),
+      std::move(attributionRules),
+      std::move(aggregationFormats),
+      std::move(attributionResults),
+      std::move(attributionReformattedResults),
+      std::move(tpmArrays),
+      std::move(cvmArrays)};
+}
+
+// Runs both parties on the multi rule inputs and returns the revealed metrics
+// of every rule, in the order of rules.
+std::vector<AggregationOutputMetrics> computeMultiRuleAggregations(
+    common::InputEncryption inputEncryption,
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool reformatted,
+    uint64_t numAdIds,
+    const std::vector<size_t>& rules,
+    bool aggregateRulesTogether) {
+  auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+
+  auto compute0 = reformatted ? computeAggregationsReformattedWithScheduler<0>
+                              : computeAggregationsWithScheduler<0>;
+  auto compute1 = reformatted ? computeAggregationsReformattedWithScheduler<1>
+                              : computeAggregationsWithScheduler<1>;
+  auto future0 = std::async(
+      compute0,
+      0,
+      makeMultiRuleInput(common::PUBLISHER, inputEncryption, numAdIds, rules),
+      inputEncryption,
+      std::move(factories[0]),
+      schedulerCreator,
+      aggregateRulesTogether);
+  auto future1 = std::async(
+      compute1,
+      1,
+      makeMultiRuleInput(common::PARTNER, inputEncryption, numAdIds, rules),
+      inputEncryption,
+      std::move(factories[1]),
+      schedulerCreator,
+      aggregateRulesTogether);
+
+  auto res0 = future0.get();
+  auto res1 = future1.get();
+
+  std::vector<AggregationOutputMetrics> outputs;
+  for (auto rule : rules) {
+    outputs.push_back(revealXORedResult(
+        res0, res1, common::MEASUREMENT, kMultiRuleNames.at(rule)));
+  }
+  return outputs;
+}
+
+// Aggregates several rules in one ORAM and checks every rule against a run of
+// the per rule path with that rule alone. With 3 ad ids the ad id index
+// (numAdIds + 1 values) exactly fills the rule stride, so a slot off by one
+// would land in the next rule.
+void testMultipleRulesTogetherWithScheduler(
+    common::InputEncryption inputEncryption,
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool reformatted) {
+  std::vector<std::pair<uint64_t, std::vector<size_t>>> cases{
+      {3, {0, 1}}, {4, {0, 1, 2}}};
+
+  for (const auto& [numAdIds, rules] : cases) {
+    auto together = computeMultiRuleAggregations(
+        inputEncryption,
+        schedulerCreator,
+        reformatted,
+        numAdIds,
+        rules,
+        /* aggregateRulesTogether */ true);
+    ASSERT_EQ(together.size(), rules.size());
+
+    for (size_t i = 0; i < rules.size(); ++i) {
+      auto alone = computeMultiRuleAggregations(
+          inputEncryption,
+          schedulerCreator,
+          reformatted,
+          numAdIds,
+          {rules.at(i)},
+          /* aggregateRulesTogether */ false);
+      FOLLY_EXPECT_JSON_EQ(together.at(i).toJson(), alone.at(0).toJson());
+    }
+    // the rules have different attribution results, so equal outputs would
+    // mean they were aggregated into the same slots
+    EXPECT_NE(
+        folly::parseJson(together.at(0).toJson()),
+        folly::parseJson(together.at(1).toJson()));
+  }
+}
+
+// Without attribution rules both paths return no metrics, in particular the
+// shared ORAM is not built for a rule that does not exist.
+void testNoRulesWithScheduler(
+    common::InputEncryption inputEncryption,
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool reformatted) {
+  for (bool aggregateRulesTogether : {false, true}) {
+    auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+
+    auto compute0 = reformatted
+        ? computeAggregationsReformattedWithScheduler<0>
+        : computeAggregationsWithScheduler<0>;
+    auto compute1 = reformatted
+        ? computeAggregationsReformattedWithScheduler<1>
+        : computeAggregationsWithScheduler<1>;
+    auto future0 = std::async(
+        compute0,
+        0,
+        makeMultiRuleInput(common::PUBLISHER, inputEncryption, 3, {}),
+        inputEncryption,
+        std::move(factories[0]),
+        schedulerCreator,
+        aggregateRulesTogether);
+    auto future1 = std::async(
+        compute1,
+        1,
+        makeMultiRuleInput(common::PARTNER, inputEncryption, 3, {}),
+        inputEncryption,
+        std::move(factories[1]),
+        schedulerCreator,
+        aggregateRulesTogether);
+
+    EXPECT_TRUE(future0.get().ruleToMetrics.empty());
+    EXPECT_TRUE(future1.get().ruleToMetrics.empty());
+  }
+}
+
 class AggregationGameTestFixture
     : public ::testing::TestWithParam<
           std::tuple<common::SchedulerType, common::InputEncryption>> {};
@@ -653,6 +878,57 @@ TEST_P(AggregationGameTestFixture, TestCorrectnessReformatted) {
       inputEncryption, fbpcf::getSchedulerCreator<unsafe>(schedulerType));
 }
 
+TEST_P(AggregationGameTestFixture, TestCorrectnessRulesTogether) {
+  auto [schedulerType, inputEncryption] = GetParam();
+
+  testCorrectnessWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* aggregateRulesTogether */ true);
+}
+
+TEST_P(AggregationGameTestFixture, TestCorrectnessReformattedRulesTogether) {
+  auto [schedulerType, inputEncryption] = GetParam();
+
+  testCorrectnessReformattedWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* aggregateRulesTogether */ true);
+}
+
+TEST_P(AggregationGameTestFixture, TestCorrectnessMultipleRulesTogether) {
+  auto [schedulerType, inputEncryption] = GetParam();
+
+  testMultipleRulesTogetherWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* reformatted */ false);
+}
+
+TEST_P(
+    AggregationGameTestFixture,
+    TestCorrectnessReformattedMultipleRulesTogether) {
+  auto [schedulerType, inputEncryption] = GetParam();
+
+  testMultipleRulesTogetherWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* reformatted */ true);
+}
+
+TEST_P(AggregationGameTestFixture, TestNoAttributionRules) {
+  auto [schedulerType, inputEncryption] = GetParam();
+
+  testNoRulesWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* reformatted */ false);
+  testNoRulesWithScheduler(
+      inputEncryption,
+      fbpcf::getSchedulerCreator<unsafe>(schedulerType),
+      /* reformatted */ true);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     AggregationGameTest,
     AggregationGameTestFixture,
@@ -7,11 +7,14 @@
 
 #pragma once
 
+#include <fbpcf/io/api/BufferedWriter.h>
 #include <fbpcf/io/api/FileIOWrappers.h>
+#include <fbpcf/io/api/FileWriter.h>
 #include <fbpcf/scheduler/NetworkPlaintextSchedulerFactory.h>
 #include <string>
 #include "fbpcf/engine/communication/IPartyCommunicationAgentFactory.h"
 #include "fbpcf/scheduler/LazySchedulerFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/common/SchedulerStatistics.h"
 #include "fbpcs/emp_games/pcf2_attribution/AttributionGame.h"
 
@@ -34,7 +37,8 @@ class AttributionApp {
       std::shared_ptr<fbpcf::util::MetricCollector> metricCollector,
       bool useXorEncryption,
       std::uint32_t startFileIndex = 0U,
-      int numFiles = 1)
+      int numFiles = 1,
+      std::shared_ptr<common::FileIndexQueue> fileIndexQueue = nullptr)
       : communicationAgentFactory_(std::move(communicationAgentFactory)),
         attributionRules_{attributionRules},
         inputFilenames_(inputFilenames),
@@ -43,6 +47,7 @@ class AttributionApp {
         useXorEncryption_(useXorEncryption),
         startFileIndex_(startFileIndex),
         numFiles_(numFiles),
+        fileIndexQueue_(std::move(fileIndexQueue)),
         schedulerStatistics_{0, 0, 0, 0} {}
 
   void run() {
@@ -57,14 +62,31 @@ class AttributionApp {
     AttributionGame<schedulerId, usingBatch, inputEncryption> game(
         std::move(scheduler));
 
-    // Compute attributions sequentially on numFiles files, starting from
-    // startFileIndex
-    for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+    auto computeFile = [&](size_t i) {
       CHECK_LT(i, inputFilenames_.size())
           << "File index exceeds number of files.";
       auto inputData = getInputData(inputFilenames_.at(i));
       auto output = game.computeAttributions(MY_ROLE, inputData);
       putOutputData(output, outputFilenames_.at(i));
+    };
+
+    if (fileIndexQueue_ != nullptr) {
+      // Keep the game alive and compute attributions on whichever file is
+      // handed out next, until all files are done
+      common::FileAssigner fileAssigner(
+          MY_ROLE,
+          fileIndexQueue_,
+          communicationAgentFactory_->create(
+              1 - MY_ROLE, "attribution_file_assigner"));
+      while (auto i = fileAssigner.next()) {
+        computeFile(*i);
+      }
+    } else {
+      // Compute attributions sequentially on numFiles files, starting from
+      // startFileIndex
+      for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+        computeFile(i);
+      }
     }
 
     auto gateStatistics =
@@ -108,8 +130,11 @@ class AttributionApp {
   void putOutputData(
       const AttributionOutputMetrics& attributions,
       std::string outputPath) {
-    std::string content = attributions.toJson();
-    fbpcf::io::FileIOWrappers::writeFile(outputPath, content);
+    auto fileWriter = std::make_unique<fbpcf::io::FileWriter>(outputPath);
+    auto bufferedWriter =
+        std::make_unique<fbpcf::io::BufferedWriter>(std::move(fileWriter));
+    attributions.writeJson(*bufferedWriter);
+    bufferedWriter->close();
   }
 
  private:
@@ -122,6 +147,7 @@ class AttributionApp {
   bool useXorEncryption_;
   const std::uint32_t startFileIndex_;
   const int numFiles_;
+  std::shared_ptr<common::FileIndexQueue> fileIndexQueue_;
   common::SchedulerStatistics schedulerStatistics_;
 };
 
@@ -42,6 +42,10 @@ class AttributionGame : public fbpcf::frontend::MpcGame<schedulerId> {
       PrivateConversion<schedulerId, usingBatch, inputEncryption>,
       !usingBatch>;
 
+  using PrivateIsClickT = ConditionalVector<
+      PrivateIsClick<schedulerId, usingBatch, inputEncryption>,
+      !usingBatch>;
+
   /**
    * Publisher shares attribution rules with partner.
    */
@@ -63,6 +67,15 @@ class AttributionGame : public fbpcf::frontend::MpcGame<schedulerId> {
   std::vector<PrivateConversionT> privatelyShareConversions(
       const std::vector<ConversionT<usingBatch>>& conversions);
 
+  /**
+   * Publisher shares isClick of xor encrypted touchpoints, along with the
+   * touchpoint validity bits every attribution rule's thresholds need.
+   */
+  std::vector<PrivateIsClickT> privatelyShareIsClicks(
+      const std::vector<TouchpointT<usingBatch>>& touchpoints,
+      const std::vector<PrivateTouchpointT>& privateTouchpoints,
+      size_t batchSize);
+
   /**
    * Publisher shares touchpoints thresholds, to optimize attribution
    * computation.
@@ -75,6 +88,20 @@ class AttributionGame : public fbpcf::frontend::MpcGame<schedulerId> {
           attributionRule,
       size_t batchSize);
 
+  /**
+   * Same as above, but reuses privateIsClicks from privatelyShareIsClicks
+   * for xor encrypted inputs, so that they are shared once for all rules.
+   * privateIsClicks is ignored for other input encryptions.
+   */
+  std::vector<std::vector<SecTimestampT<schedulerId, usingBatch>>>
+  privatelyShareThresholds(
+      const std::vector<TouchpointT<usingBatch>>& touchpoints,
+      const std::vector<PrivateTouchpointT>& privateTouchpoints,
+      const std::vector<PrivateIsClickT>& privateIsClicks,
+      const AttributionRule<schedulerId, usingBatch, inputEncryption>&
+          attributionRule,
+      size_t batchSize);
+
   /**
    * Retrieve the original Ad Ids from touchpoint data
    */
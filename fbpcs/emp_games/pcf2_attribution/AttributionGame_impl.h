@@ -60,6 +60,40 @@ AttributionGame<schedulerId, usingBatch, inputEncryption>::
   }
 }
 
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::vector<typename AttributionGame<schedulerId, usingBatch, inputEncryption>::
+                PrivateIsClickT>
+AttributionGame<schedulerId, usingBatch, inputEncryption>::
+    privatelyShareIsClicks(
+        const std::vector<TouchpointT<usingBatch>>& touchpoints,
+        const std::vector<PrivateTouchpointT>& privateTouchpoints,
+        size_t batchSize) {
+  if (usingBatch && batchSize == 0) {
+    throw std::invalid_argument(
+        "Must provide positive batch size for batch execution!");
+  }
+  std::vector<PrivateIsClickT> output;
+  output.reserve(touchpoints.size());
+  for (size_t i = 0; i < touchpoints.size(); ++i) {
+    if constexpr (usingBatch) {
+      output.emplace_back(
+          touchpoints.at(i), privateTouchpoints.at(i), batchSize);
+    } else {
+      PrivateIsClickT row;
+      row.reserve(touchpoints.at(i).size());
+      for (size_t j = 0; j < touchpoints.at(i).size(); ++j) {
+        row.emplace_back(
+            touchpoints.at(i).at(j), privateTouchpoints.at(i).at(j), batchSize);
+      }
+      output.push_back(std::move(row));
+    }
+  }
+  return output;
+}
+
 template <
     int schedulerId,
     bool usingBatch,
@@ -72,6 +106,32 @@ AttributionGame<schedulerId, usingBatch, inputEncryption>::
         const AttributionRule<schedulerId, usingBatch, inputEncryption>&
             attributionRule,
         size_t batchSize) {
+  std::vector<PrivateIsClickT> privateIsClicks;
+  if constexpr (inputEncryption == common::InputEncryption::Xor) {
+    privateIsClicks =
+        privatelyShareIsClicks(touchpoints, privateTouchpoints, batchSize);
+  }
+  return privatelyShareThresholds(
+      touchpoints,
+      privateTouchpoints,
+      privateIsClicks,
+      attributionRule,
+      batchSize);
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::vector<std::vector<SecTimestampT<schedulerId, usingBatch>>>
+AttributionGame<schedulerId, usingBatch, inputEncryption>::
+    privatelyShareThresholds(
+        const std::vector<TouchpointT<usingBatch>>& touchpoints,
+        const std::vector<PrivateTouchpointT>& privateTouchpoints,
+        const std::vector<PrivateIsClickT>& privateIsClicks,
+        const AttributionRule<schedulerId, usingBatch, inputEncryption>&
+            attributionRule,
+        size_t batchSize) {
   std::vector<std::vector<SecTimestampT<schedulerId, usingBatch>>> output;
 
   if constexpr (inputEncryption != common::InputEncryption::Xor) {
@@ -97,27 +157,19 @@ AttributionGame<schedulerId, usingBatch, inputEncryption>::
         throw std::invalid_argument(
             "Must provide positive batch size for batch execution!");
       }
-      auto privateIsClick = common::privatelyShareArray<
-          Touchpoint<usingBatch>,
-          PrivateIsClick<schedulerId, usingBatch, inputEncryption>>(
-          touchpoints);
       for (size_t i = 0; i < touchpoints.size(); ++i) {
         auto thresholds = attributionRule.computeThresholdsPrivate(
-            privateTouchpoints.at(i), privateIsClick.at(i), batchSize);
+            privateTouchpoints.at(i), privateIsClicks.at(i), batchSize);
         output.push_back(std::move(thresholds));
       }
     } else {
-      auto privateIsClick = common::privatelyShareArrays<
-          Touchpoint<usingBatch>,
-          PrivateIsClick<schedulerId, usingBatch, inputEncryption>>(
-          touchpoints);
       for (size_t i = 0; i < privateTouchpoints.size(); ++i) {
         std::vector<std::vector<SecTimestamp<schedulerId, usingBatch>>>
             thresholdRow;
         for (size_t j = 0; j < privateTouchpoints.at(i).size(); ++j) {
           auto thresholds = attributionRule.computeThresholdsPrivate(
               privateTouchpoints.at(i).at(j),
-              privateIsClick.at(i).at(j),
+              privateIsClicks.at(i).at(j),
               batchSize);
           thresholdRow.push_back(std::move(thresholds));
         }
@@ -581,12 +633,19 @@ AttributionGame<schedulerId, usingBatch, inputEncryption>::computeAttributions(
   auto attributionRules =
       shareAttributionRules(myRole, inputData.getAttributionRules());
 
+  // isClick and the touchpoint validity are the same for every rule
+  std::vector<PrivateIsClickT> privateIsClicks;
+  if constexpr (inputEncryption == common::InputEncryption::Xor) {
+    XLOG(INFO, "Privately sharing isClick...");
+    privateIsClicks = privatelyShareIsClicks(touchpoints, tpArrays, numIds);
+  }
+
   for (const auto& attributionRule : attributionRules) {
     XLOGF(INFO, "Computing attributions for rule {}", attributionRule->name);
 
     // Share touchpoint threshold information for computing attributions
     auto thresholdArrays = privatelyShareThresholds(
-        touchpoints, tpArrays, *attributionRule, numIds);
+        touchpoints, tpArrays, privateIsClicks, *attributionRule, numIds);
     CHECK_EQ(thresholdArrays.size(), tpArrays.size())
         << "threshold arrays and touchpoint arrays are not the same length.";
 
@@ -617,7 +676,7 @@ AttributionGame<schedulerId, usingBatch, inputEncryption>::computeAttributions(
           INFO,
           "Retrieving attribution results for rule {}.",
           attributionRule->name);
-      attributionMetrics.attributionResult =
+      attributionMetrics.reformattedResult =
           attributionReformattedOutput.reveal();
 
     } else {
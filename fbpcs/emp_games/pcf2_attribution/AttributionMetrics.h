@@ -103,11 +103,11 @@ class AttributionInputMetrics {
  */
 struct AttributionMetrics {
   std::unordered_map<std::string, AttributionResult> formatToAttribution;
-  AttributionResult attributionResult;
+  AttributionReformattedColumns reformattedResult;
 
   folly::dynamic toDynamic() const {
     if (FLAGS_use_new_output_format) {
-      return attributionResult;
+      return reformattedResult.toDynamic();
     } else {
       folly::dynamic res = folly::dynamic::object();
       for (auto kv : formatToAttribution) {
@@ -122,7 +122,8 @@ struct AttributionMetrics {
   static AttributionMetrics fromDynamic(const folly::dynamic& obj) {
     AttributionMetrics metrics{};
     if (FLAGS_use_new_output_format) {
-      metrics.attributionResult = obj;
+      metrics.reformattedResult =
+          AttributionReformattedColumns::fromDynamic(obj);
       return metrics;
     } else {
       std::unordered_map<std::string, AttributionResult> formatToAttribution;
@@ -144,6 +145,20 @@ struct AttributionMetrics {
     return folly::toJson(obj);
   }
 
+  /**
+   * Write the same JSON as toJson() to writer. The new output format is
+   * streamed straight from the revealed columns.
+   */
+  template <typename Writer>
+  void writeJson(Writer& writer) const {
+    if (FLAGS_use_new_output_format) {
+      reformattedResult.writeJson(writer);
+    } else {
+      auto json = folly::toJson(toDynamic());
+      writer.writeString(json);
+    }
+  }
+
   static AttributionMetrics fromJson(const std::string& str) {
     auto obj = folly::parseJson(str);
     return fromDynamic(obj);
@@ -192,6 +207,28 @@ struct AttributionOutputMetrics {
     auto obj = folly::parseJson(str);
     return fromDynamic(obj);
   }
+
+  /**
+   * Stream the output as compact JSON to writer, one rule at a time.
+   */
+  template <typename Writer>
+  void writeJson(Writer& writer) const {
+    std::string buffer = "{";
+    bool first = true;
+    for (const auto& [ruleName, metrics] : ruleToMetrics) {
+      if (!first) {
+        buffer.push_back(',');
+      }
+      first = false;
+      buffer.append(folly::toJson(ruleName));
+      buffer.push_back(':');
+      writer.writeString(buffer);
+      metrics.writeJson(writer);
+      buffer.clear();
+    }
+    buffer.push_back('}');
+    writer.writeString(buffer);
+  }
 };
 
 struct CompressedAdIdToOriginalAdId {
@@ -5,6 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
 #include <folly/dynamic.h>
 
 #include "fbpcs/emp_games/common/Constants.h"
@@ -37,25 +43,125 @@ struct OutputMetricReformatted {
   }
 };
 
+namespace detail {
+
+// Serialized output is flushed to the writer in chunks of about this size, so
+// the full serialized shard never has to be held in memory.
+constexpr size_t kSerializationChunkSize = 1 << 20;
+
+template <typename Writer>
+inline void
+flushSerializationBuffer(Writer& writer, std::string& buffer, bool force) {
+  if (force || buffer.size() >= kSerializationChunkSize) {
+    if (!buffer.empty()) {
+      writer.writeString(buffer);
+    }
+    buffer.clear();
+  }
+}
+
+} // namespace detail
+
 /**
- * Store map from uid to vector of attribution results
+ * Store the attribution results of all uids as flat parallel columns. The
+ * results of uids[i] are at positions [uidOffsets[i], uidOffsets[i + 1]) of
+ * adIds, convValues and isAttributed.
  */
-struct AttributionReformattedFmt {
-  std::unordered_map<int64_t, std::vector<OutputMetricReformatted>> idToMetrics;
+struct AttributionReformattedColumns {
+  std::vector<int64_t> uids;
+  std::vector<uint64_t> uidOffsets{0};
+  std::vector<uint16_t> adIds;
+  std::vector<uint64_t> convValues;
+  std::vector<bool> isAttributed;
+
+  void reserve(size_t numUids, size_t numMetrics) {
+    uids.reserve(numUids);
+    uidOffsets.reserve(numUids + 1);
+    adIds.reserve(numMetrics);
+    convValues.reserve(numMetrics);
+    isAttributed.reserve(numMetrics);
+  }
+
+  void addMetric(uint16_t adId, uint64_t convValue, bool attributed) {
+    adIds.push_back(adId);
+    convValues.push_back(convValue);
+    isAttributed.push_back(attributed);
+  }
+
+  // Close the results added since the previous uid as belonging to uid.
+  void finishUid(int64_t uid) {
+    uids.push_back(uid);
+    uidOffsets.push_back(adIds.size());
+  }
+
+  size_t numUids() const {
+    return uids.size();
+  }
+
+  OutputMetricReformatted getMetric(size_t index) const {
+    return OutputMetricReformatted{
+        adIds.at(index), convValues.at(index), isAttributed.at(index)};
+  }
 
   folly::dynamic toDynamic() const {
     folly::dynamic res = folly::dynamic::object();
 
-    for (const auto& [k1, v1] : idToMetrics) {
-      auto uid = std::to_string(k1);
+    for (size_t i = 0; i < uids.size(); ++i) {
       folly::dynamic metricList = folly::dynamic::array();
-      for (const auto& metric : v1) {
-        metricList.push_back(metric.toDynamic());
+      for (auto j = uidOffsets.at(i); j < uidOffsets.at(i + 1); ++j) {
+        metricList.push_back(getMetric(j).toDynamic());
       }
-      res.insert(uid, metricList);
+      res.insert(std::to_string(uids.at(i)), std::move(metricList));
     }
     return res;
   }
+
+  static AttributionReformattedColumns fromDynamic(const folly::dynamic& obj) {
+    AttributionReformattedColumns out;
+    for (const auto& [uid, metricList] : obj.items()) {
+      for (const auto& metric : metricList) {
+        auto parsed = OutputMetricReformatted::fromDynamic(metric);
+        out.addMetric(parsed.ad_id, parsed.conv_value, parsed.is_attributed);
+      }
+      out.finishUid(folly::to<int64_t>(uid.asString()));
+    }
+    return out;
+  }
+
+  /**
+   * Stream the same JSON object as folly::toJson(toDynamic()) to writer,
+   * which must provide writeString(std::string&), without building the
+   * intermediate dynamic tree.
+   */
+  template <typename Writer>
+  void writeJson(Writer& writer) const {
+    std::string buffer;
+    buffer.reserve(detail::kSerializationChunkSize + 256);
+    buffer.push_back('{');
+    for (size_t i = 0; i < uids.size(); ++i) {
+      if (i > 0) {
+        buffer.push_back(',');
+      }
+      buffer.push_back('"');
+      folly::toAppend(uids.at(i), &buffer);
+      buffer.append("\":[");
+      for (auto j = uidOffsets.at(i); j < uidOffsets.at(i + 1); ++j) {
+        if (j > uidOffsets.at(i)) {
+          buffer.push_back(',');
+        }
+        buffer.append("{\"ad_id\":");
+        folly::toAppend(adIds.at(j), &buffer);
+        buffer.append(",\"conv_value\":");
+        folly::toAppend(convValues.at(j), &buffer);
+        buffer.append(",\"is_attributed\":");
+        buffer.append(isAttributed.at(j) ? "true}" : "false}");
+      }
+      buffer.push_back(']');
+      detail::flushSerializationBuffer(writer, buffer, false);
+    }
+    buffer.push_back('}');
+    detail::flushSerializationBuffer(writer, buffer, true);
+  }
 };
 
 using AttributionResult = folly::dynamic;
@@ -85,8 +191,8 @@ class AttributionReformattedOutput {
   /**
    * Reveal attribution result as XOR secret shares
    */
-  AttributionResult reveal() {
-    AttributionReformattedFmt out;
+  AttributionReformattedColumns reveal() {
+    AttributionReformattedColumns out;
 
     std::vector<std::vector<uint64_t>> revealedAdId;
     std::vector<std::vector<uint64_t>> revealedConvValue;
@@ -155,15 +261,23 @@ class AttributionReformattedOutput {
     uint32_t convValueSumOmniscient = 0;
     uint32_t attributionCountOmniscient = 0;
 
+    size_t numMetrics = 0;
+    if constexpr (usingBatch) {
+      numMetrics = uids_.size() * revealedAdId.size();
+    } else {
+      for (const auto& revealedAdIdArray : revealedAdId) {
+        numMetrics += revealedAdIdArray.size();
+      }
+    }
+    out.reserve(uids_.size(), numMetrics);
+
     for (size_t i = 0; i < uids_.size(); ++i) {
-      std::vector<OutputMetricReformatted> revealedMetric;
       if constexpr (usingBatch) {
         for (size_t j = 0; j < revealedAdId.size(); ++j) {
-          OutputMetricReformatted outputMetric{
-              static_cast<uint16_t>(revealedAdId.at(j).at(i)),
-              revealedConvValue.at(j).at(i),
-              revealedAttribution.at(j).at(i)};
-          revealedMetric.emplace_back(outputMetric);
+          out.addMetric(
+              static_cast<uint16_t>(revealedAdId[j][i]),
+              revealedConvValue[j][i],
+              revealedAttribution[j][i]);
           IF_OMNISCIENT_MODE {
             if (revealedAdId.at(j).at(i)) {
               adIdCountOmniscient++;
@@ -177,11 +291,10 @@ class AttributionReformattedOutput {
       } else {
         // revealedAttribution for non-batch is related to batch by transposing
         for (size_t j = 0; j < revealedAdId.at(i).size(); ++j) {
-          OutputMetricReformatted outputMetric{
-              static_cast<uint16_t>(revealedAdId.at(i).at(j)),
-              revealedConvValue.at(i).at(j),
-              revealedAttribution.at(i).at(j)};
-          revealedMetric.emplace_back(outputMetric);
+          out.addMetric(
+              static_cast<uint16_t>(revealedAdId[i][j]),
+              revealedConvValue[i][j],
+              revealedAttribution[i][j]);
 
           IF_OMNISCIENT_MODE {
             if (revealedAdId.at(i).at(j)) {
@@ -194,7 +307,7 @@ class AttributionReformattedOutput {
           }
         }
       }
-      out.idToMetrics.emplace(uids_.at(i), revealedMetric);
+      out.finishUid(uids_.at(i));
     }
 
     OMNISCIENT_ONLY_XLOGF(DBG, "Ad_id count: {}", adIdCountOmniscient);
@@ -203,7 +316,7 @@ class AttributionReformattedOutput {
     OMNISCIENT_ONLY_XLOGF(
         DBG, "Attribution count: {}", attributionCountOmniscient);
 
-    return out.toDynamic();
+    return out;
   }
 
  private:
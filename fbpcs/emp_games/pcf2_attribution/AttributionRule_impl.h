@@ -73,7 +73,7 @@ class LastClickRule
       secondsInThreshold = PubTimestamp<schedulerId, usingBatch>(
           static_cast<std::uint32_t>(threshold_.count()));
     }
-    auto isValidClick = privateIsClick.isClick & (zero < privateTp.ts);
+    const auto& isValidClick = privateIsClick.isValidClick;
     auto thresholdNDays = privateTp.ts + secondsInThreshold;
     auto thresholdNDaysClick = zero.mux(isValidClick, thresholdNDays);
     return std::vector<SecTimestamp<schedulerId, usingBatch>>{
@@ -169,8 +169,8 @@ class LastTouch_ClickNDays_ImpressionMDays
       secondsInNDays = PubTimestamp<schedulerId, usingBatch>(
           static_cast<std::uint32_t>(clickThreshold_.count()));
     }
-    auto isValid = zero < privateTp.ts;
-    auto isValidClick = privateIsClick.isClick & isValid;
+    const auto& isValid = privateIsClick.isValid;
+    const auto& isValidClick = privateIsClick.isValidClick;
     auto thresholdMDays = privateTp.ts + secondsInMDays;
     auto thresholdMDaysTouch = zero.mux(isValid, thresholdMDays);
 
@@ -268,7 +268,7 @@ class LastClick_2_7Days
           PubTimestamp<schedulerId, usingBatch>(kSecondsInSevenDays);
     }
 
-    auto isValidClick = privateIsClick.isClick & (zero < privateTp.ts);
+    const auto& isValidClick = privateIsClick.isValidClick;
 
     auto lowerBoundOneDay = privateTp.ts + secondsInOneDay;
     auto lowerBoundOneDayClick = zero.mux(isValidClick, lowerBoundOneDay);
@@ -377,8 +377,8 @@ class LastTouch_2_7Days
           PubTimestamp<schedulerId, usingBatch>(kSecondsInSevenDays);
     }
 
-    auto isValid = zero < privateTp.ts;
-    auto isValidClick = privateIsClick.isClick & isValid;
+    const auto& isValid = privateIsClick.isValid;
+    const auto& isValidClick = privateIsClick.isValidClick;
 
     auto lowerBoundAndUpperBoundOneDay = privateTp.ts + secondsInOneDay;
     auto lowerBoundOneDayClick =
@@ -452,7 +452,7 @@ class LastClick_1Day_TargetId
       zero = PubTimestamp<schedulerId, usingBatch>(uint32_t(0));
       secondsInOneDay = PubTimestamp<schedulerId, usingBatch>(kSecondsInOneDay);
     }
-    auto isValidClick = privateIsClick.isClick & (zero < privateTp.ts);
+    const auto& isValidClick = privateIsClick.isValidClick;
     auto thresholdOneDay = privateTp.ts + secondsInOneDay;
     auto thresholdOneDayClick = zero.mux(isValidClick, thresholdOneDay);
     return std::vector<SecTimestamp<schedulerId, usingBatch>>{
@@ -14,6 +14,7 @@
 #include <fbpcf/engine/communication/SocketPartyCommunicationAgent.h>
 #include <folly/dynamic.h>
 #include "fbpcf/engine/communication/SocketPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
 #include "fbpcs/emp_games/pcf2_attribution/AttributionApp.h"
 
 namespace pcf2_attribution {
@@ -60,7 +61,7 @@ template <
     common::InputEncryption inputEncryption>
 inline common::SchedulerStatistics startAttributionAppsForShardedFilesHelper(
     bool useXorEncryption,
-    std::uint32_t startFileIndex,
+    std::shared_ptr<common::FileIndexQueue> fileIndexQueue,
     std::uint32_t remainingThreads,
     std::string serverIp,
     int port,
@@ -73,14 +74,7 @@ inline common::SchedulerStatistics startAttributionAppsForShardedFilesHelper(
   common::SchedulerStatistics schedulerStatistics{
       0, 0, 0, 0, folly::dynamic::object()};
 
-  // split files evenly across threads
-  auto remainingFiles =
-      static_cast<std::int64_t>(inputFilenames.size()) - startFileIndex;
-  if (remainingFiles > 0) {
-    auto numFiles = (remainingThreads > remainingFiles)
-        ? 1U
-        : (remainingFiles / remainingThreads);
-
+  if (remainingThreads > 0) {
     std::map<
         int,
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory::
@@ -96,7 +90,8 @@ inline common::SchedulerStatistics startAttributionAppsForShardedFilesHelper(
         fbpcf::engine::communication::SocketPartyCommunicationAgentFactory>(
         PARTY, partyInfos, tlsInfo, metricCollector);
 
-    // Each AttributionApp runs numFiles sequentially on a single thread
+    // Each AttributionApp keeps its scheduler on a single thread and takes
+    // files from the shared queue until all files are done.
     // Publisher uses even schedulerId and partner uses odd schedulerId
     auto app = std::make_unique<pcf2_attribution::AttributionApp<
         PARTY,
@@ -109,8 +104,9 @@ inline common::SchedulerStatistics startAttributionAppsForShardedFilesHelper(
         outputFilenames,
         metricCollector,
         useXorEncryption,
-        startFileIndex,
-        numFiles);
+        0U,
+        0,
+        fileIndexQueue);
 
     auto future = std::async([&app]() {
       app->run();
@@ -125,7 +121,7 @@ inline common::SchedulerStatistics startAttributionAppsForShardedFilesHelper(
             usingBatch,
             inputEncryption>(
             useXorEncryption,
-            startFileIndex + numFiles,
+            fileIndexQueue,
             remainingThreads - 1,
             serverIp,
             port,
@@ -163,7 +159,7 @@ inline common::SchedulerStatistics startAttributionAppsForShardedFiles(
       usingBatch,
       inputEncryption>(
       useXorEncryption,
-      0U,
+      std::make_shared<common::FileIndexQueue>(inputFilenames.size()),
       numThreads,
       serverIp,
       port,
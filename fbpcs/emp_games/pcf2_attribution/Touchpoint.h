@@ -69,15 +69,25 @@ struct PrivateTouchpoint {
   }
 };
 
-// Used for privately sharing isClick for xor encrypted inputs
+// Used for privately sharing isClick for xor encrypted inputs, together with
+// the validity bits derived from it. None of these depend on the attribution
+// rule, so they are computed once and used by the thresholds of every rule.
 template <
     int schedulerId,
     bool usingBatch,
     common::InputEncryption inputEncryption>
 struct PrivateIsClick {
   SecBit<schedulerId, usingBatch> isClick;
+  // whether the touchpoint has a valid (positive) timestamp
+  SecBit<schedulerId, usingBatch> isValid;
+  // whether the touchpoint is a click with a valid timestamp
+  SecBit<schedulerId, usingBatch> isValidClick;
 
-  explicit PrivateIsClick(const Touchpoint<usingBatch>& touchpoint) {
+  PrivateIsClick(
+      const Touchpoint<usingBatch>& touchpoint,
+      const PrivateTouchpoint<schedulerId, usingBatch, inputEncryption>&
+          privateTp,
+      size_t batchSize) {
     if constexpr (inputEncryption == common::InputEncryption::Xor) {
       typename SecBit<schedulerId, usingBatch>::ExtractedBit extractedIsClick(
           touchpoint.isClick);
@@ -86,6 +96,16 @@ struct PrivateIsClick {
       isClick = SecBit<schedulerId, usingBatch>(
           touchpoint.isClick, common::PUBLISHER);
     }
+
+    PubTimestamp<schedulerId, usingBatch> zero;
+    if constexpr (usingBatch) {
+      zero = PubTimestamp<schedulerId, usingBatch>(
+          std::vector<uint32_t>(batchSize, 0));
+    } else {
+      zero = PubTimestamp<schedulerId, usingBatch>(uint32_t(0));
+    }
+    isValid = zero < privateTp.ts;
+    isValidClick = isClick & isValid;
   }
 };
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "folly/dynamic.h"
+#include "folly/json.h"
+
+#include "fbpcs/emp_games/pcf2_attribution/AttributionMetrics.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionOptions.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionReformattedOutput.h"
+
+namespace pcf2_attribution {
+
+// Collects everything written, one entry per writeString call.
+struct StringWriter {
+  std::vector<std::string> chunks;
+
+  void writeString(const std::string& data) {
+    chunks.push_back(data);
+  }
+
+  std::string str() const {
+    std::string out;
+    for (const auto& chunk : chunks) {
+      out.append(chunk);
+    }
+    return out;
+  }
+};
+
+AttributionReformattedColumns exampleColumns(size_t numUids) {
+  AttributionReformattedColumns columns;
+  for (size_t i = 0; i < numUids; ++i) {
+    // uid 0 has no results
+    for (size_t j = 0; j < i % 4; ++j) {
+      columns.addMetric(
+          static_cast<uint16_t>(i % 7), 1000 * i + j, (i + j) % 2 == 0);
+    }
+    columns.finishUid(static_cast<int64_t>(i) - 1);
+  }
+  return columns;
+}
+
+TEST(AttributionMetricsTest, TestReformattedColumnsDynamic) {
+  auto columns = exampleColumns(5);
+
+  auto expected = folly::parseJson(R"({
+    "-1": [],
+    "0": [{"ad_id": 1, "conv_value": 1000, "is_attributed": false}],
+    "1": [
+      {"ad_id": 2, "conv_value": 2000, "is_attributed": true},
+      {"ad_id": 2, "conv_value": 2001, "is_attributed": false}
+    ],
+    "2": [
+      {"ad_id": 3, "conv_value": 3000, "is_attributed": false},
+      {"ad_id": 3, "conv_value": 3001, "is_attributed": true},
+      {"ad_id": 3, "conv_value": 3002, "is_attributed": false}
+    ],
+    "3": []
+  })");
+  EXPECT_EQ(columns.toDynamic(), expected);
+
+  auto parsed = AttributionReformattedColumns::fromDynamic(expected);
+  EXPECT_EQ(parsed.toDynamic(), expected);
+  ASSERT_EQ(parsed.numUids(), 5);
+  EXPECT_EQ(parsed.uidOffsets.back(), 6);
+}
+
+TEST(AttributionMetricsTest, TestReformattedColumnsWriteJson) {
+  // large enough to be flushed to the writer in several chunks
+  auto columns = exampleColumns(50000);
+
+  StringWriter writer;
+  columns.writeJson(writer);
+
+  EXPECT_GT(writer.chunks.size(), 1);
+  for (const auto& chunk : writer.chunks) {
+    EXPECT_FALSE(chunk.empty());
+  }
+  auto json = writer.str();
+  EXPECT_EQ(json.find('\n'), std::string::npos);
+  EXPECT_EQ(folly::parseJson(json), columns.toDynamic());
+
+  StringWriter emptyWriter;
+  AttributionReformattedColumns{}.writeJson(emptyWriter);
+  EXPECT_EQ(emptyWriter.str(), "{}");
+}
+
+// The streamed output has to parse to the same value as the pretty-printed
+// JSON the attribution app used to write.
+TEST(AttributionMetricsTest, TestOutputMetricsWriteJsonNewFormat) {
+  FLAGS_use_new_output_format = true;
+
+  AttributionOutputMetrics output;
+  output.ruleToMetrics["last_click_1d"].reformattedResult = exampleColumns(10);
+  output.ruleToMetrics["last_touch_1d"].reformattedResult = exampleColumns(3);
+
+  StringWriter writer;
+  output.writeJson(writer);
+
+  EXPECT_EQ(folly::parseJson(writer.str()), folly::parseJson(output.toJson()));
+  EXPECT_EQ(
+      AttributionOutputMetrics::fromJson(writer.str()).toDynamic(),
+      output.toDynamic());
+}
+
+TEST(AttributionMetricsTest, TestOutputMetricsWriteJsonOldFormat) {
+  FLAGS_use_new_output_format = false;
+
+  auto defaultResult = folly::parseJson(R"({
+    "1": [{"is_attributed": true}, {"is_attributed": false}],
+    "2": [{"is_attributed": false}, {"is_attributed": false}]
+  })");
+  AttributionOutputMetrics output;
+  output.ruleToMetrics["last_click_1d"].formatToAttribution.emplace(
+      "default", defaultResult);
+
+  StringWriter writer;
+  output.writeJson(writer);
+
+  EXPECT_EQ(folly::parseJson(writer.str()), folly::parseJson(output.toJson()));
+  EXPECT_EQ(
+      folly::parseJson(writer.str()),
+      folly::dynamic::object(
+          "last_click_1d", folly::dynamic::object("default", defaultResult)));
+
+  StringWriter emptyWriter;
+  AttributionOutputMetrics{}.writeJson(emptyWriter);
+  EXPECT_EQ(emptyWriter.str(), "{}");
+}
+
+} // namespace pcf2_attribution
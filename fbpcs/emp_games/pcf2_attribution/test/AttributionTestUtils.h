@@ -50,8 +50,8 @@ inline AttributionOutputMetrics revealXORedResult(
   AttributionResult aliceAttribution;
   AttributionResult bobAttribution;
   if (FLAGS_use_new_output_format) {
-    aliceAttribution = aliceAttributionOutput.attributionResult;
-    bobAttribution = bobAttributionOutput.attributionResult;
+    aliceAttribution = aliceAttributionOutput.reformattedResult.toDynamic();
+    bobAttribution = bobAttributionOutput.reformattedResult.toDynamic();
   } else {
     // Attribution output contains results based on attribution format
     // (currently only "default").
@@ -111,12 +111,12 @@ inline AttributionOutputMetrics revealXORedReformattedResult(
   folly::dynamic revealedAttributionMetrics = folly::dynamic::object;
   folly::dynamic revealedMetricsMap = folly::dynamic::object;
   folly::dynamic revealedAttributionResultsPerId = folly::dynamic::object;
-  AttributionResult& aliceAttribution = FLAGS_use_new_output_format
-      ? aliceAttributionOutput.attributionResult
+  AttributionResult aliceAttribution = FLAGS_use_new_output_format
+      ? aliceAttributionOutput.reformattedResult.toDynamic()
       : aliceAttributionOutput.formatToAttribution.at(attributionFormat);
 
-  AttributionResult& bobAttribution = FLAGS_use_new_output_format
-      ? bobAttributionOutput.attributionResult
+  AttributionResult bobAttribution = FLAGS_use_new_output_format
+      ? bobAttributionOutput.reformattedResult.toDynamic()
       : bobAttributionOutput.formatToAttribution.at(attributionFormat);
 
   // first sort the keys so that alice and bob are reading
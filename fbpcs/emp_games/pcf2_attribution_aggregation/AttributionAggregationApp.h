@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fbpcf/io/api/BufferedWriter.h>
+#include <fbpcf/io/api/FileIOWrappers.h>
+#include <fbpcf/io/api/FileWriter.h>
+#include <fbpcf/scheduler/LazySchedulerFactory.h>
+#include <fbpcf/scheduler/NetworkPlaintextSchedulerFactory.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fbpcf/engine/communication/IPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
+#include "fbpcs/emp_games/common/SchedulerStatistics.h"
+#include "fbpcs/emp_games/pcf2_aggregation/AggregationGame.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionGame.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionAggregationOptions.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionShareHandoff.h"
+
+namespace pcf2_attribution_aggregation {
+
+/**
+ * Runs attribution and then aggregation on each input file in one process.
+ * The attribution shares of a file are handed to the aggregation game in
+ * memory instead of being written out and parsed back by a second binary.
+ * Each game installs its own scheduler, so attribution runs on
+ * attributionSchedulerId and aggregation on aggregationSchedulerId; both
+ * games stay alive across all files of this app.
+ */
+template <
+    int MY_ROLE,
+    int attributionSchedulerId,
+    int aggregationSchedulerId,
+    common::InputEncryption inputEncryption>
+class AttributionAggregationApp {
+ public:
+  AttributionAggregationApp(
+      std::unique_ptr<
+          fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+          communicationAgentFactory,
+      const std::string& attributionRules,
+      const std::string& aggregationFormats,
+      const std::vector<std::string>& inputFilenames,
+      const std::vector<std::string>& outputFilenames,
+      const std::vector<std::string>& attributionOutputFilenames,
+      std::shared_ptr<fbpcf::util::MetricCollector> metricCollector,
+      bool useXorEncryption,
+      std::uint32_t startFileIndex = 0U,
+      int numFiles = 1,
+      int concurrency = 1,
+      std::shared_ptr<common::FileIndexQueue> fileIndexQueue = nullptr)
+      : communicationAgentFactory_(std::move(communicationAgentFactory)),
+        attributionRules_{attributionRules},
+        aggregationFormats_{aggregationFormats},
+        inputFilenames_(inputFilenames),
+        outputFilenames_(outputFilenames),
+        attributionOutputFilenames_(attributionOutputFilenames),
+        metricCollector_(metricCollector),
+        useXorEncryption_(useXorEncryption),
+        startFileIndex_(startFileIndex),
+        numFiles_(numFiles),
+        concurrency_(concurrency),
+        fileIndexQueue_(std::move(fileIndexQueue)),
+        schedulerStatistics_{0, 0, 0, 0} {}
+
+  void run() {
+    // Attribution and aggregation reveal XOR shares under the same flag, so
+    // both schedulers are either real or plaintext
+    auto attributionScheduler = createScheduler();
+    auto aggregationScheduler = createScheduler();
+
+    // The file assigner agent is created before the aggregation game takes
+    // ownership of the communication agent factory
+    std::unique_ptr<common::FileAssigner> fileAssigner = nullptr;
+    if (fileIndexQueue_ != nullptr) {
+      fileAssigner = std::make_unique<common::FileAssigner>(
+          MY_ROLE,
+          fileIndexQueue_,
+          communicationAgentFactory_->create(
+              1 - MY_ROLE, "attribution_aggregation_file_assigner"));
+    }
+
+    pcf2_attribution::
+        AttributionGame<attributionSchedulerId, true, inputEncryption>
+            attributionGame(std::move(attributionScheduler));
+    pcf2_aggregation::AggregationGame<aggregationSchedulerId> aggregationGame(
+        std::move(aggregationScheduler),
+        std::move(communicationAgentFactory_),
+        inputEncryption,
+        concurrency_);
+
+    auto computeFile = [&](size_t i) {
+      CHECK_LT(i, inputFilenames_.size())
+          << "File index exceeds number of files.";
+      XLOG(INFO) << "MY_ROLE: " << MY_ROLE
+                 << ", attributionRules_: " << attributionRules_
+                 << ", aggregationFormats_: " << aggregationFormats_
+                 << ", input_path: " << inputFilenames_.at(i);
+
+      auto attributionOutput = attributionGame.computeAttributions(
+          MY_ROLE,
+          pcf2_attribution::AttributionInputMetrics<true, inputEncryption>{
+              MY_ROLE, attributionRules_, inputFilenames_.at(i)});
+      if (!attributionOutputFilenames_.empty()) {
+        putAttributionOutputData(
+            attributionOutput, attributionOutputFilenames_.at(i));
+      }
+
+      auto aggregationInput = getAggregationInput(
+          MY_ROLE,
+          inputEncryption,
+          inputFilenames_.at(i),
+          aggregationFormats_,
+          attributionOutput);
+      pcf2_aggregation::AggregationOutputMetrics output;
+      if (FLAGS_use_new_output_format) {
+        output = aggregationGame.computeAggregationsReformatted(
+            MY_ROLE, aggregationInput, FLAGS_aggregate_rules_together);
+      } else {
+        output = aggregationGame.computeAggregations(
+            MY_ROLE, aggregationInput, FLAGS_aggregate_rules_together);
+      }
+      fbpcf::io::FileIOWrappers::writeFile(
+          outputFilenames_.at(i),
+          FLAGS_use_binary_output ? output.toBinary() : output.toJson());
+    };
+
+    if (fileAssigner != nullptr) {
+      // Keep the games alive and compute on whichever file is handed out
+      // next, until all files are done
+      while (auto i = fileAssigner->next()) {
+        computeFile(*i);
+      }
+    } else {
+      // Compute sequentially on numFiles files, starting from startFileIndex
+      for (size_t i = startFileIndex_; i < startFileIndex_ + numFiles_; ++i) {
+        computeFile(i);
+      }
+    }
+
+    collectSchedulerStatistics<attributionSchedulerId>();
+    collectSchedulerStatistics<aggregationSchedulerId>();
+    schedulerStatistics_.details = metricCollector_->collectMetrics();
+  }
+
+  common::SchedulerStatistics getSchedulerStatistics() {
+    return schedulerStatistics_;
+  }
+
+ private:
+  std::unique_ptr<fbpcf::scheduler::IScheduler> createScheduler() {
+    return useXorEncryption_
+        ? fbpcf::scheduler::getLazySchedulerFactoryWithRealEngine(
+              MY_ROLE, *communicationAgentFactory_, metricCollector_)
+              ->create()
+        : fbpcf::scheduler::NetworkPlaintextSchedulerFactory<false>(
+              MY_ROLE, *communicationAgentFactory_, metricCollector_)
+              .create();
+  }
+
+  void putAttributionOutputData(
+      const pcf2_attribution::AttributionOutputMetrics& attributions,
+      const std::string& outputPath) {
+    auto fileWriter = std::make_unique<fbpcf::io::FileWriter>(outputPath);
+    auto bufferedWriter =
+        std::make_unique<fbpcf::io::BufferedWriter>(std::move(fileWriter));
+    attributions.writeJson(*bufferedWriter);
+    bufferedWriter->close();
+  }
+
+  template <int schedulerId>
+  void collectSchedulerStatistics() {
+    auto gateStatistics =
+        fbpcf::scheduler::SchedulerKeeper<schedulerId>::getGateStatistics();
+    XLOGF(
+        INFO,
+        "Scheduler {}: Non-free gate count = {}, Free gate count = {}",
+        schedulerId,
+        gateStatistics.first,
+        gateStatistics.second);
+
+    auto trafficStatistics =
+        fbpcf::scheduler::SchedulerKeeper<schedulerId>::getTrafficStatistics();
+    XLOGF(
+        INFO,
+        "Scheduler {}: Sent network traffic = {}, Received network traffic = {}",
+        schedulerId,
+        trafficStatistics.first,
+        trafficStatistics.second);
+
+    schedulerStatistics_.nonFreeGates += gateStatistics.first;
+    schedulerStatistics_.freeGates += gateStatistics.second;
+    schedulerStatistics_.sentNetwork += trafficStatistics.first;
+    schedulerStatistics_.receivedNetwork += trafficStatistics.second;
+    fbpcf::scheduler::SchedulerKeeper<schedulerId>::deleteEngine();
+  }
+
+  std::unique_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+      communicationAgentFactory_;
+  std::string attributionRules_;
+  std::string aggregationFormats_;
+  std::vector<std::string> inputFilenames_;
+  std::vector<std::string> outputFilenames_;
+  std::vector<std::string> attributionOutputFilenames_;
+  std::shared_ptr<fbpcf::util::MetricCollector> metricCollector_;
+  bool useXorEncryption_;
+  const std::uint32_t startFileIndex_;
+  const int numFiles_;
+  const int concurrency_;
+  std::shared_ptr<common::FileIndexQueue> fileIndexQueue_;
+  common::SchedulerStatistics schedulerStatistics_;
+};
+
+} // namespace pcf2_attribution_aggregation
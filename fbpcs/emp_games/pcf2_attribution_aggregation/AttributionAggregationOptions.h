@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <gflags/gflags_declare.h>
+
+// The fused binary defines the flags of both games, so that their code reads
+// the same FLAGS_ variables as in the standalone binaries
+#include "fbpcs/emp_games/pcf2_aggregation/AggregationOptions.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionOptions.h"
+
+DECLARE_string(attribution_output_base_path);
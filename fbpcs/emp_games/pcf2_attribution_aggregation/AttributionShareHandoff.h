@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "fbpcs/emp_games/common/Constants.h"
+#include "fbpcs/emp_games/pcf2_aggregation/AggregationMetrics.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionMetrics.h"
+
+namespace pcf2_attribution_aggregation {
+
+/**
+ * Attribution rules of the output in a fixed order. Both parties hold the
+ * same rules, so sorting the names keeps their attribution shares aligned
+ * without depending on the iteration order of the hash map.
+ */
+inline std::vector<std::string> getAttributionRules(
+    const pcf2_attribution::AttributionOutputMetrics& attributionOutput) {
+  std::vector<std::string> rules;
+  rules.reserve(attributionOutput.ruleToMetrics.size());
+  for (const auto& [rule, metrics] : attributionOutput.ruleToMetrics) {
+    rules.push_back(rule);
+  }
+  std::sort(rules.begin(), rules.end());
+  return rules;
+}
+
+/**
+ * The default format attribution shares of each rule, per uid in ascending
+ * uid order, i.e. the layout AggregationInputMetrics reads from the
+ * attribution output file. The attribution game reveals the default format
+ * as a folly::dynamic tree, so the shares are still converted from that tree
+ * with AttributionResult::fromDynamic; only writing and parsing the JSON text
+ * is skipped.
+ */
+inline pcf2_aggregation::AggregationMetrics::AttributionResultsList
+getAttributionResults(
+    const pcf2_attribution::AttributionOutputMetrics& attributionOutput,
+    const std::vector<std::string>& rules) {
+  pcf2_aggregation::AggregationMetrics::AttributionResultsList out;
+  out.reserve(rules.size());
+  for (const auto& rule : rules) {
+    const auto& formatToAttribution =
+        attributionOutput.ruleToMetrics.at(rule).formatToAttribution;
+    for (const auto& [format, resultPerPid] : formatToAttribution) {
+      std::map<int64_t, std::vector<pcf2_aggregation::AttributionResult>>
+          attributionsPerPid;
+      for (const auto& [pid, results] : resultPerPid.items()) {
+        std::vector<pcf2_aggregation::AttributionResult> attributionResults;
+        attributionResults.reserve(results.size());
+        for (const auto& result : results) {
+          attributionResults.push_back(
+              pcf2_aggregation::AttributionResult::fromDynamic(result));
+        }
+        attributionsPerPid.emplace(
+            pid.asInt(), std::move(attributionResults));
+      }
+
+      std::vector<std::vector<pcf2_aggregation::AttributionResult>>
+          attributionPidVector;
+      attributionPidVector.reserve(attributionsPerPid.size());
+      for (auto& [pid, attributionResults] : attributionsPerPid) {
+        attributionPidVector.push_back(std::move(attributionResults));
+      }
+      out.push_back(std::move(attributionPidVector));
+    }
+  }
+  return out;
+}
+
+/**
+ * Same as above for the new output format, read straight from the revealed
+ * columns without any folly::dynamic in between.
+ */
+inline pcf2_aggregation::AggregationMetrics::AttributionReformattedResultsList
+getAttributionReformattedResults(
+    const pcf2_attribution::AttributionOutputMetrics& attributionOutput,
+    const std::vector<std::string>& rules) {
+  pcf2_aggregation::AggregationMetrics::AttributionReformattedResultsList out;
+  out.reserve(rules.size());
+  for (const auto& rule : rules) {
+    const auto& columns =
+        attributionOutput.ruleToMetrics.at(rule).reformattedResult;
+
+    std::vector<size_t> uidOrder(columns.numUids());
+    std::iota(uidOrder.begin(), uidOrder.end(), 0);
+    std::sort(uidOrder.begin(), uidOrder.end(), [&](size_t a, size_t b) {
+      return columns.uids[a] < columns.uids[b];
+    });
+
+    std::vector<std::vector<pcf2_aggregation::AttributionReformattedResult>>
+        attributionPidVector;
+    attributionPidVector.reserve(uidOrder.size());
+    for (auto i : uidOrder) {
+      std::vector<pcf2_aggregation::AttributionReformattedResult> results;
+      results.reserve(columns.uidOffsets[i + 1] - columns.uidOffsets[i]);
+      for (auto j = columns.uidOffsets[i]; j < columns.uidOffsets[i + 1];
+           ++j) {
+        results.push_back(pcf2_aggregation::AttributionReformattedResult{
+            columns.adIds[j], columns.convValues[j], columns.isAttributed[j]});
+      }
+      attributionPidVector.push_back(std::move(results));
+    }
+    out.push_back(std::move(attributionPidVector));
+  }
+  return out;
+}
+
+/**
+ * Aggregation input for one shard, with the attribution shares taken from
+ * attributionOutput instead of the attribution output file. The metadata is
+ * read from the same clear text input the attribution game read.
+ */
+inline pcf2_aggregation::AggregationInputMetrics getAggregationInput(
+    int myRole,
+    common::InputEncryption inputEncryption,
+    const std::filesystem::path& inputClearTextFilePath,
+    const std::string& aggregationFormats,
+    const pcf2_attribution::AttributionOutputMetrics& attributionOutput) {
+  auto rules = getAttributionRules(attributionOutput);
+  pcf2_aggregation::AggregationMetrics::AttributionResultsList
+      attributionResults;
+  pcf2_aggregation::AggregationMetrics::AttributionReformattedResultsList
+      attributionReformattedResults;
+  if (FLAGS_use_new_output_format) {
+    attributionReformattedResults =
+        getAttributionReformattedResults(attributionOutput, rules);
+  } else {
+    attributionResults = getAttributionResults(attributionOutput, rules);
+  }
+  return pcf2_aggregation::AggregationInputMetrics{
+      myRole,
+      inputEncryption,
+      inputClearTextFilePath,
+      aggregationFormats,
+      std::move(rules),
+      std::move(attributionResults),
+      std::move(attributionReformattedResults)};
+}
+
+} // namespace pcf2_attribution_aggregation
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+
+#include <fbpcf/engine/communication/SocketPartyCommunicationAgent.h>
+#include <folly/dynamic.h>
+#include "fbpcf/engine/communication/SocketPartyCommunicationAgentFactory.h"
+#include "fbpcs/emp_games/common/FileAssigner.h"
+#include "fbpcs/emp_games/pcf2_attribution/Constants.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionAggregationApp.h"
+
+namespace pcf2_attribution_aggregation {
+
+template <
+    int PARTY,
+    int index,
+    common::InputEncryption inputEncryption>
+inline common::SchedulerStatistics
+startAttributionAggregationAppsForShardedFilesHelper(
+    bool useXorEncryption,
+    std::shared_ptr<common::FileIndexQueue> fileIndexQueue,
+    int remainingThreads,
+    int numThreads,
+    std::string serverIp,
+    int port,
+    std::string attributionRules,
+    std::string aggregationFormats,
+    std::vector<std::string>& inputFilenames,
+    std::vector<std::string>& outputFilenames,
+    std::vector<std::string>& attributionOutputFilenames,
+    fbpcf::engine::communication::SocketPartyCommunicationAgent::TlsInfo&
+        tlsInfo) {
+  // aggregate scheduler statistics across apps
+  common::SchedulerStatistics schedulerStatistics{
+      0, 0, 0, 0, folly::dynamic::object()};
+
+  if (remainingThreads > 0) {
+    std::map<
+        int,
+        fbpcf::engine::communication::SocketPartyCommunicationAgentFactory::
+            PartyInfo>
+        partyInfos(
+            {{0, {serverIp, port + index * 100}},
+             {1, {serverIp, port + index * 100}}});
+
+    auto metricCollector = std::make_shared<fbpcf::util::MetricCollector>(
+        "attribution_aggregation_metrics_for_thread_" + std::to_string(index));
+
+    auto communicationAgentFactory = std::make_unique<
+        fbpcf::engine::communication::SocketPartyCommunicationAgentFactory>(
+        PARTY, partyInfos, tlsInfo, metricCollector);
+
+    // Each app keeps its two schedulers on a single thread and takes files
+    // from the shared queue until all files are done.
+    // Publisher uses even schedulerIds and partner uses odd schedulerIds,
+    // aggregation schedulers come after all attribution schedulers
+    auto app = std::make_unique<AttributionAggregationApp<
+        PARTY,
+        2 * index + PARTY,
+        2 * (pcf2_attribution::kMaxConcurrency + index) + PARTY,
+        inputEncryption>>(
+        std::move(communicationAgentFactory),
+        attributionRules,
+        aggregationFormats,
+        inputFilenames,
+        outputFilenames,
+        attributionOutputFilenames,
+        metricCollector,
+        useXorEncryption,
+        0U,
+        0,
+        numThreads,
+        fileIndexQueue);
+
+    auto future = std::async([&app]() {
+      app->run();
+      return app->getSchedulerStatistics();
+    });
+
+    if constexpr (index < pcf2_attribution::kMaxConcurrency) {
+      if (remainingThreads > 1) {
+        auto remainingStats =
+            startAttributionAggregationAppsForShardedFilesHelper<
+                PARTY,
+                index + 1,
+                inputEncryption>(
+                useXorEncryption,
+                fileIndexQueue,
+                remainingThreads - 1,
+                numThreads,
+                serverIp,
+                port,
+                attributionRules,
+                aggregationFormats,
+                inputFilenames,
+                outputFilenames,
+                attributionOutputFilenames,
+                tlsInfo);
+        schedulerStatistics.add(remainingStats);
+      }
+    }
+    auto stats = future.get();
+    schedulerStatistics.add(stats);
+  }
+  return schedulerStatistics;
+}
+
+/**
+ * attributionOutputFilenames may be empty, in which case the attribution
+ * results are only handed to aggregation in memory.
+ */
+template <int PARTY, common::InputEncryption inputEncryption>
+inline common::SchedulerStatistics
+startAttributionAggregationAppsForShardedFiles(
+    bool useXorEncryption,
+    std::vector<std::string>& inputFilenames,
+    std::vector<std::string>& outputFilenames,
+    std::vector<std::string>& attributionOutputFilenames,
+    int16_t concurrency,
+    std::string serverIp,
+    int port,
+    std::string attributionRules,
+    std::string aggregationFormats,
+    fbpcf::engine::communication::SocketPartyCommunicationAgent::TlsInfo&
+        tlsInfo) {
+  // use only as many threads as the number of files
+  auto numThreads = std::min((int)inputFilenames.size(), (int)concurrency);
+
+  return startAttributionAggregationAppsForShardedFilesHelper<
+      PARTY,
+      0,
+      inputEncryption>(
+      useXorEncryption,
+      std::make_shared<common::FileIndexQueue>(inputFilenames.size()),
+      numThreads,
+      numThreads,
+      serverIp,
+      port,
+      attributionRules,
+      aggregationFormats,
+      inputFilenames,
+      outputFilenames,
+      attributionOutputFilenames,
+      tlsInfo);
+}
+
+} // namespace pcf2_attribution_aggregation
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gflags/gflags.h>
+#include <signal.h>
+#include <string>
+
+#include "folly/Format.h"
+#include "folly/init/Init.h"
+#include "folly/logging/xlog.h"
+
+#include <fbpcf/aws/AwsSdk.h>
+#include <fbpcs/performance_tools/CostEstimation.h>
+
+#include "fbpcs/emp_games/pcf2_aggregation/MainUtil.h"
+#include "fbpcs/emp_games/pcf2_attribution/Constants.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionAggregationOptions.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/MainUtil.h"
+
+template <int PARTY>
+static common::SchedulerStatistics startApps(
+    std::vector<std::string>& inputFilenames,
+    std::vector<std::string>& outputFilenames,
+    std::vector<std::string>& attributionOutputFilenames,
+    int16_t concurrency,
+    fbpcf::engine::communication::SocketPartyCommunicationAgent::TlsInfo&
+        tlsInfo) {
+  if (FLAGS_input_encryption == 1) {
+    return pcf2_attribution_aggregation::
+        startAttributionAggregationAppsForShardedFiles<
+            PARTY,
+            common::InputEncryption::PartnerXor>(
+            FLAGS_use_xor_encryption,
+            inputFilenames,
+            outputFilenames,
+            attributionOutputFilenames,
+            concurrency,
+            FLAGS_server_ip,
+            FLAGS_port,
+            FLAGS_attribution_rules,
+            FLAGS_aggregators,
+            tlsInfo);
+  } else if (FLAGS_input_encryption == 2) {
+    return pcf2_attribution_aggregation::
+        startAttributionAggregationAppsForShardedFiles<
+            PARTY,
+            common::InputEncryption::Xor>(
+            FLAGS_use_xor_encryption,
+            inputFilenames,
+            outputFilenames,
+            attributionOutputFilenames,
+            concurrency,
+            FLAGS_server_ip,
+            FLAGS_port,
+            FLAGS_attribution_rules,
+            FLAGS_aggregators,
+            tlsInfo);
+  } else {
+    return pcf2_attribution_aggregation::
+        startAttributionAggregationAppsForShardedFiles<
+            PARTY,
+            common::InputEncryption::Plaintext>(
+            FLAGS_use_xor_encryption,
+            inputFilenames,
+            outputFilenames,
+            attributionOutputFilenames,
+            concurrency,
+            FLAGS_server_ip,
+            FLAGS_port,
+            FLAGS_attribution_rules,
+            FLAGS_aggregators,
+            tlsInfo);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  fbpcs::performance_tools::CostEstimation cost =
+      fbpcs::performance_tools::CostEstimation(
+          "attribution_aggregation",
+          FLAGS_log_cost_s3_bucket,
+          FLAGS_log_cost_s3_region,
+          "pcf2");
+  cost.start();
+
+  fbpcf::AwsSdk::aquire();
+
+  signal(SIGPIPE, SIG_IGN);
+
+  FLAGS_party--; // subtract 1 because we use 0 and 1 for publisher and partner
+                 // instead of 1 and 2
+
+  XLOGF(INFO, "Party: {}", FLAGS_party);
+  XLOGF(INFO, "Server IP: {}", FLAGS_server_ip);
+  XLOGF(INFO, "Port: {}", FLAGS_port);
+  XLOGF(INFO, "Base input path: {}", FLAGS_input_base_path);
+  XLOGF(INFO, "Base output path: {}", FLAGS_output_base_path);
+  XLOGF(
+      INFO,
+      "Base attribution output path: {}",
+      FLAGS_attribution_output_base_path);
+  XLOGF(INFO, "Run Id: {}", FLAGS_run_id);
+  XLOGF(INFO, "PC Feature Flags: {}", FLAGS_pc_feature_flags);
+
+  common::SchedulerStatistics schedulerStatistics;
+
+  try {
+    auto inputFilenames = pcf2_aggregation::getIOInputFilenames(
+        FLAGS_num_files,
+        FLAGS_input_base_path,
+        FLAGS_file_start_index,
+        FLAGS_use_postfix);
+
+    auto outputFilenames = pcf2_aggregation::getIOInputFilenames(
+        FLAGS_num_files,
+        FLAGS_output_base_path,
+        FLAGS_file_start_index,
+        FLAGS_use_postfix);
+
+    // The attribution results are only written out when asked for
+    std::vector<std::string> attributionOutputFilenames;
+    if (!FLAGS_attribution_output_base_path.empty()) {
+      attributionOutputFilenames = pcf2_aggregation::getIOInputFilenames(
+          FLAGS_num_files,
+          FLAGS_attribution_output_base_path,
+          FLAGS_file_start_index,
+          FLAGS_use_postfix);
+    }
+
+    int16_t concurrency = static_cast<int16_t>(FLAGS_concurrency);
+    CHECK_LE(concurrency, pcf2_attribution::kMaxConcurrency)
+        << "Concurrency must be at most " << pcf2_attribution::kMaxConcurrency;
+
+    auto tlsInfo = fbpcf::engine::communication::getTlsInfoFromArgs(
+        FLAGS_use_tls,
+        FLAGS_ca_cert_path,
+        FLAGS_server_cert_path,
+        FLAGS_private_key_path,
+        "");
+
+    if (FLAGS_party == common::PUBLISHER) {
+      XLOGF(INFO, "Attribution Rules: {}", FLAGS_attribution_rules);
+      XLOGF(INFO, "Aggregation Format: {}", FLAGS_aggregators);
+
+      XLOG(INFO)
+          << "Starting attribution and aggregation as Publisher, will wait for Partner...";
+
+      schedulerStatistics = startApps<common::PUBLISHER>(
+          inputFilenames,
+          outputFilenames,
+          attributionOutputFilenames,
+          concurrency,
+          tlsInfo);
+    } else if (FLAGS_party == common::PARTNER) {
+      XLOG(INFO)
+          << "Starting attribution and aggregation as Partner, will wait for Publisher...";
+
+      schedulerStatistics = startApps<common::PARTNER>(
+          inputFilenames,
+          outputFilenames,
+          attributionOutputFilenames,
+          concurrency,
+          tlsInfo);
+    } else {
+      XLOGF(FATAL, "Invalid Party: {}", FLAGS_party);
+    }
+
+  } catch (const std::exception& e) {
+    XLOG(ERR)
+        << "Error: Exception caught in Attribution and Aggregation run.\n \t error msg: "
+        << e.what() << "\n \t input directory: " << FLAGS_input_base_path;
+    std::exit(1);
+  }
+
+  cost.end();
+  XLOG(INFO, cost.getEstimatedCostString());
+
+  XLOGF(
+      INFO,
+      "Non-free gate count = {}, Free gate count = {}",
+      schedulerStatistics.nonFreeGates,
+      schedulerStatistics.freeGates);
+
+  XLOGF(
+      INFO,
+      "Sent network traffic = {}, Received network traffic = {}",
+      schedulerStatistics.sentNetwork,
+      schedulerStatistics.receivedNetwork);
+
+  if (FLAGS_log_cost) {
+    bool run_name_specified = FLAGS_run_name != "";
+    auto run_name = run_name_specified ? FLAGS_run_name : "temp_run_name";
+    auto party = (FLAGS_party == common::PUBLISHER) ? "Publisher" : "Partner";
+
+    folly::dynamic extra_info = common::getCostExtraInfo(
+        party,
+        FLAGS_input_base_path,
+        FLAGS_output_base_path,
+        FLAGS_num_files,
+        FLAGS_file_start_index,
+        FLAGS_concurrency,
+        FLAGS_use_xor_encryption,
+        schedulerStatistics);
+
+    folly::dynamic costDict =
+        cost.getEstimatedCostDynamic(run_name, party, extra_info);
+
+    auto objectName = run_name_specified
+        ? run_name
+        : folly::to<std::string>(
+              FLAGS_run_name, '_', costDict["timestamp"].asString());
+
+    XLOGF(INFO, "{}", cost.writeToS3(party, objectName, costDict));
+  }
+
+  return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "folly/Format.h"
+#include "folly/Random.h"
+#include "folly/test/JsonTestUtil.h"
+
+#include <fbpcf/io/api/FileIOWrappers.h>
+#include "fbpcf/engine/communication/test/AgentFactoryCreationHelper.h"
+#include "fbpcf/util/MetricCollector.h"
+#include "fbpcs/emp_games/common/Constants.h"
+#include "fbpcs/emp_games/common/MetricsBinaryFormat.h"
+#include "fbpcs/emp_games/common/TestUtil.h"
+#include "fbpcs/emp_games/pcf2_aggregation/AggregationApp.h"
+#include "fbpcs/emp_games/pcf2_aggregation/test/AggregationTestUtils.h"
+#include "fbpcs/emp_games/pcf2_attribution/AttributionApp.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionAggregationApp.h"
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionAggregationOptions.h"
+
+namespace pcf2_attribution_aggregation {
+
+const auto kInputEncryption = common::InputEncryption::Plaintext;
+
+template <int PARTY, int attributionSchedulerId, int aggregationSchedulerId>
+static void runAttributionAggregationApp(
+    const std::string& attributionRules,
+    const std::string& aggregationFormats,
+    const std::string& inputPath,
+    const std::string& outputPath,
+    std::unique_ptr<
+        fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+        communicationAgentFactory) {
+  auto metricCollector = std::make_shared<fbpcf::util::MetricCollector>(
+      "attribution_aggregation_test");
+  AttributionAggregationApp<
+      PARTY,
+      attributionSchedulerId,
+      aggregationSchedulerId,
+      kInputEncryption>(
+      std::move(communicationAgentFactory),
+      attributionRules,
+      aggregationFormats,
+      std::vector<std::string>{inputPath},
+      std::vector<std::string>{outputPath},
+      std::vector<std::string>{},
+      metricCollector,
+      /* useXorEncryption */ true)
+      .run();
+}
+
+template <int PARTY, int schedulerId>
+static void runAttributionApp(
+    const std::string& attributionRules,
+    const std::string& inputPath,
+    const std::string& outputPath,
+    std::unique_ptr<
+        fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+        communicationAgentFactory) {
+  auto metricCollector =
+      std::make_shared<fbpcf::util::MetricCollector>("attribution_test");
+  // the fused app always attributes in batches
+  pcf2_attribution::AttributionApp<PARTY, schedulerId, true, kInputEncryption>(
+      std::move(communicationAgentFactory),
+      attributionRules,
+      std::vector<std::string>{inputPath},
+      std::vector<std::string>{outputPath},
+      metricCollector,
+      /* useXorEncryption */ true)
+      .run();
+}
+
+template <int PARTY, int schedulerId>
+static void runAggregationApp(
+    const std::string& aggregationFormat,
+    const std::string& attributionOutputPath,
+    const std::string& inputPath,
+    const std::string& outputPath,
+    std::unique_ptr<
+        fbpcf::engine::communication::IPartyCommunicationAgentFactory>
+        communicationAgentFactory) {
+  auto metricCollector =
+      std::make_shared<fbpcf::util::MetricCollector>("aggregation_test");
+  pcf2_aggregation::AggregationApp<PARTY, schedulerId>(
+      kInputEncryption,
+      common::Visibility::Xor,
+      std::move(communicationAgentFactory),
+      aggregationFormat,
+      std::vector<std::string>{attributionOutputPath},
+      std::vector<std::string>{inputPath},
+      std::vector<std::string>{outputPath},
+      metricCollector)
+      .run();
+}
+
+class AttributionAggregationAppTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    baseDir_ = private_measurement::test_util::getBaseDirFromPath(__FILE__);
+    std::string tempDir = std::filesystem::temp_directory_path();
+    auto suffix = folly::Random::secureRand64();
+    for (const auto& name :
+         {"attribution_alice",
+          "attribution_bob",
+          "aggregation_alice",
+          "aggregation_bob",
+          "fused_alice",
+          "fused_bob"}) {
+      tempPaths_.push_back(
+          folly::sformat("{}/{}.json_{}", tempDir, name, suffix));
+    }
+  }
+
+  void TearDown() override {
+    for (const auto& path : tempPaths_) {
+      std::filesystem::remove(path);
+    }
+  }
+
+  static pcf2_aggregation::AggregationOutputMetrics readOutput(
+      const std::string& outputPath) {
+    auto output = fbpcf::io::FileIOWrappers::readFile(outputPath);
+    return common::isMetricsBinary(output)
+        ? pcf2_aggregation::AggregationOutputMetrics::fromBinary(output)
+        : pcf2_aggregation::AggregationOutputMetrics::fromJson(output);
+  }
+
+  // pcf2_attribution followed by pcf2_aggregation, through the attribution
+  // output files
+  pcf2_aggregation::AggregationOutputMetrics runPipeline(
+      const std::string& attributionRule,
+      const std::string& publisherInputPath,
+      const std::string& partnerInputPath) {
+    const auto& attributionOutputAlice = tempPaths_.at(0);
+    const auto& attributionOutputBob = tempPaths_.at(1);
+    const auto& outputAlice = tempPaths_.at(2);
+    const auto& outputBob = tempPaths_.at(3);
+
+    auto attributionFactories =
+        fbpcf::engine::communication::getInMemoryAgentFactory(2);
+    auto attributionAlice = std::async(
+        runAttributionApp<common::PUBLISHER, 0>,
+        attributionRule,
+        publisherInputPath,
+        attributionOutputAlice,
+        std::move(attributionFactories[0]));
+    auto attributionBob = std::async(
+        runAttributionApp<common::PARTNER, 1>,
+        "",
+        partnerInputPath,
+        attributionOutputBob,
+        std::move(attributionFactories[1]));
+    attributionAlice.get();
+    attributionBob.get();
+
+    auto aggregationFactories =
+        fbpcf::engine::communication::getInMemoryAgentFactory(2);
+    auto aggregationAlice = std::async(
+        runAggregationApp<common::PUBLISHER, 2>,
+        common::MEASUREMENT,
+        attributionOutputAlice,
+        publisherInputPath,
+        outputAlice,
+        std::move(aggregationFactories[0]));
+    auto aggregationBob = std::async(
+        runAggregationApp<common::PARTNER, 3>,
+        "",
+        attributionOutputBob,
+        partnerInputPath,
+        outputBob,
+        std::move(aggregationFactories[1]));
+    aggregationAlice.get();
+    aggregationBob.get();
+
+    return pcf2_aggregation::revealXORedResult(
+        readOutput(outputAlice),
+        readOutput(outputBob),
+        common::MEASUREMENT,
+        attributionRule);
+  }
+
+  pcf2_aggregation::AggregationOutputMetrics runFused(
+      const std::string& attributionRule,
+      const std::string& publisherInputPath,
+      const std::string& partnerInputPath) {
+    const auto& outputAlice = tempPaths_.at(4);
+    const auto& outputBob = tempPaths_.at(5);
+
+    auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+    auto futureAlice = std::async(
+        runAttributionAggregationApp<common::PUBLISHER, 4, 6>,
+        attributionRule,
+        common::MEASUREMENT,
+        publisherInputPath,
+        outputAlice,
+        std::move(factories[0]));
+    auto futureBob = std::async(
+        runAttributionAggregationApp<common::PARTNER, 5, 7>,
+        "",
+        "",
+        partnerInputPath,
+        outputBob,
+        std::move(factories[1]));
+    futureAlice.get();
+    futureBob.get();
+
+    return pcf2_aggregation::revealXORedResult(
+        readOutput(outputAlice),
+        readOutput(outputBob),
+        common::MEASUREMENT,
+        attributionRule);
+  }
+
+  std::string baseDir_;
+  std::vector<std::string> tempPaths_;
+};
+
+TEST_P(AttributionAggregationAppTest, TestMatchesAttributionThenAggregation) {
+  FLAGS_use_new_output_format = GetParam();
+
+  std::vector<std::string> attributionRules{
+      common::LAST_CLICK_1D,
+      common::LAST_TOUCH_1D,
+      common::LAST_CLICK_2_7D,
+      common::LAST_TOUCH_2_7D};
+
+  for (const auto& attributionRule : attributionRules) {
+    std::string inputPrefix = baseDir_ +
+        "../../pcf2_attribution/test/test_correctness/" + attributionRule + ".";
+    std::string publisherInputPath = inputPrefix + "publisher.csv";
+    std::string partnerInputPath = inputPrefix + "partner.csv";
+
+    auto expected =
+        runPipeline(attributionRule, publisherInputPath, partnerInputPath);
+    auto output =
+        runFused(attributionRule, publisherInputPath, partnerInputPath);
+
+    FOLLY_EXPECT_JSON_EQ(output.toJson(), expected.toJson());
+    pcf2_aggregation::verifyOutput(
+        output,
+        baseDir_ + "../../pcf2_aggregation/test/test_correctness/" +
+            attributionRule + "." + common::MEASUREMENT + ".json");
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AttributionAggregationAppTest,
+    AttributionAggregationAppTest,
+    ::testing::Bool(),
+    [](const testing::TestParamInfo<AttributionAggregationAppTest::ParamType>&
+           info) {
+      return info.param ? std::string("NewOutputFormat")
+                        : std::string("OldOutputFormat");
+    });
+
+} // namespace pcf2_attribution_aggregation
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "folly/dynamic.h"
+
+#include "fbpcs/emp_games/pcf2_attribution_aggregation/AttributionShareHandoff.h"
+
+namespace pcf2_attribution_aggregation {
+
+TEST(AttributionShareHandoffTest, TestRulesAreSorted) {
+  pcf2_attribution::AttributionOutputMetrics attributionOutput;
+  attributionOutput.ruleToMetrics["last_touch_1d"] = {};
+  attributionOutput.ruleToMetrics["last_click_1d"] = {};
+
+  std::vector<std::string> expected{"last_click_1d", "last_touch_1d"};
+  EXPECT_EQ(getAttributionRules(attributionOutput), expected);
+}
+
+TEST(AttributionShareHandoffTest, TestAttributionResultsInUidOrder) {
+  pcf2_attribution::AttributionOutputMetrics attributionOutput;
+  attributionOutput.ruleToMetrics["last_click_1d"].formatToAttribution
+      ["default"] = folly::dynamic::object(
+          "10",
+          folly::dynamic::array(
+              folly::dynamic::object("is_attributed", true),
+              folly::dynamic::object("is_attributed", false)))(
+          "2",
+          folly::dynamic::array(
+              folly::dynamic::object("is_attributed", false),
+              folly::dynamic::object("is_attributed", true)));
+
+  auto results = getAttributionResults(
+      attributionOutput, getAttributionRules(attributionOutput));
+
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_EQ(results.at(0).size(), 2U);
+  // uid 2 comes before uid 10
+  EXPECT_FALSE(results.at(0).at(0).at(0).isAttributed);
+  EXPECT_TRUE(results.at(0).at(0).at(1).isAttributed);
+  EXPECT_TRUE(results.at(0).at(1).at(0).isAttributed);
+  EXPECT_FALSE(results.at(0).at(1).at(1).isAttributed);
+}
+
+TEST(AttributionShareHandoffTest, TestAttributionReformattedResults) {
+  pcf2_attribution::AttributionOutputMetrics attributionOutput;
+  auto& columns =
+      attributionOutput.ruleToMetrics["last_touch_1d"].reformattedResult;
+  columns.addMetric(3, 30, true);
+  columns.finishUid(1);
+  columns.addMetric(1, 10, false);
+  columns.addMetric(2, 20, true);
+  columns.finishUid(0);
+
+  auto results = getAttributionReformattedResults(
+      attributionOutput, getAttributionRules(attributionOutput));
+
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_EQ(results.at(0).size(), 2U);
+  ASSERT_EQ(results.at(0).at(0).size(), 2U);
+  ASSERT_EQ(results.at(0).at(1).size(), 1U);
+  EXPECT_EQ(results.at(0).at(0).at(0).adId, 1U);
+  EXPECT_EQ(results.at(0).at(0).at(0).convValue, 10U);
+  EXPECT_FALSE(results.at(0).at(0).at(0).isAttributed);
+  EXPECT_EQ(results.at(0).at(0).at(1).adId, 2U);
+  EXPECT_EQ(results.at(0).at(0).at(1).convValue, 20U);
+  EXPECT_TRUE(results.at(0).at(0).at(1).isAttributed);
+  EXPECT_EQ(results.at(0).at(1).at(0).adId, 3U);
+  EXPECT_EQ(results.at(0).at(1).at(0).convValue, 30U);
+  EXPECT_TRUE(results.at(0).at(1).at(0).isAttributed);
+}
+
+} // namespace pcf2_attribution_aggregation
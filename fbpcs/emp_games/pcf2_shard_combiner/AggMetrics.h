@@ -12,6 +12,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -20,6 +21,7 @@
 #include <fbpcf/exception/exceptions.h>
 #include <fbpcf/frontend/mpcGame.h>
 #include <fbpcs/emp_games/common/Constants.h>
+#include <fbpcs/emp_games/common/MetricsBinaryFormat.h>
 #include <fbpcs/emp_games/common/Util.h>
 
 namespace shard_combiner {
@@ -101,6 +103,15 @@ class AggMetrics {
       const std::shared_ptr<
           AggMetrics<schedulerId, usingBatch, inputEncryption>>& rhs);
 
+  // Adds rhsLeaves[i] to lhsLeaves[i] for every i. Same as accumulate() on
+  // two metrics whose kValue leaves were listed in the same order (see
+  // ShardIndex), without matching up their keys. If both lists are exactly
+  // the leaves of one SecValueBatch each, the batches are added in a single
+  // operation.
+  static void accumulateLeaves(
+      const MetricsList& lhsLeaves,
+      const MetricsList& rhsLeaves);
+
   // checks if *this >= rhs metrics and returns a variant which could be
   // bool or SecBit<> based on the instantiation.
   BitVariant<schedulerId, usingBatch> isGreaterOrEqual(const AggMetrics& rhs);
@@ -116,17 +127,16 @@ class AggMetrics {
   }
 
   MetricsValue getValue() const;
-  SecInt<schedulerId, usingBatch> getSecValueXor() const {
-    return std::get<SecInt<schedulerId, usingBatch>>(secVal_);
-  }
+  SecInt<schedulerId, usingBatch> getSecValueXor() const;
   const MetricsList& getAsList() const;
   const MetricsDict& getAsDict() const;
 
   void setValue(MetricsValue v);
 
-  // setter for XorSecretShareValue
+  // setter for XorSecretShareValue, detaches the leaf from its batch if any.
   void setSecValueXor(SecInt<schedulerId, usingBatch>& v) {
     secVal_ = std::move(v);
+    secBatch_.reset();
   }
 
   // reads val_ that contains the intShare and inits secretValue holding data
@@ -141,6 +151,14 @@ class AggMetrics {
   // Traverses through all children and calls updateSecValueFromRawInt.
   void updateAllSecVals();
 
+  // Same as calling updateAllSecVals() on each of metrics, but when batching
+  // is enabled the leaves of all metrics are gathered into one flat array and
+  // turned into a single batched secret value. That value is split once per
+  // metric into a SecValueBatch, and each leaf refers to its offset in the
+  // batch of its metric instead of holding a batch of size one.
+  static void updateAllSecValsBatched(
+      std::vector<std::shared_ptr<AggMetrics>>& metrics);
+
   // Value is moved to val_.
   void setList(MetricsList& v);
 
@@ -183,6 +201,15 @@ class AggMetrics {
   static std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
   fromJson(std::string filePath);
 
+  // Decodes a tree in the binary metrics format (see
+  // common/MetricsBinaryFormat.h) into AggMetrics object.
+  static std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+  fromBinary(std::string_view data);
+
+  // Reads a shard written either as Json or in the binary metrics format.
+  static std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+  fromFile(std::string filePath);
+
   // Emits dynamic object which can be converted to json
   folly::dynamic toDynamic() const;
 
@@ -218,6 +245,32 @@ class AggMetrics {
       const std::shared_ptr<
           AggMetrics<schedulerId, usingBatch, inputEncryption>>& rhs);
 
+  // parses the contents of a Json file into AggMetrics object.
+  static std::shared_ptr<AggMetrics> fromJsonData(const std::string& data);
+
+  // reads the next node of a binary metrics tree, including its children.
+  static std::shared_ptr<AggMetrics> readBinaryNode(
+      common::MetricsBinaryReader& reader);
+
+  // Secret values of all kValue leaves of one metric, the leaf at offset i
+  // holding the i-th element. The per-leaf values are split off only when a
+  // single leaf is read, e.g. by the threshold checks or to reveal it.
+  struct SecValueBatch {
+    SecInt<schedulerId, usingBatch> value;
+    size_t size;
+    std::vector<SecInt<schedulerId, usingBatch>> unbatched;
+  };
+
+  // returns the batch that leaves are exactly the elements of, in order, or
+  // nullptr if there is none.
+  static std::shared_ptr<SecValueBatch> getSharedSecBatch(
+      const MetricsList& leaves);
+
+  // appends all kValue leaves under metric to leaves in depth-first order.
+  static void collectLeaves(
+      const std::shared_ptr<AggMetrics>& metric,
+      std::vector<std::shared_ptr<AggMetrics>>& leaves);
+
   // helper for print
   void printSpaces(std::ostream& os, int32_t n) const;
 
@@ -228,6 +281,10 @@ class AggMetrics {
   // this is a std::variant because we'd like to support many frontend/backend
   // interface like XOR-SS, Arithmetic, etc.
   SecMetricVariant secVal_;
+  // if set, the secret value is the element at secBatchOffset_ in secBatch_
+  // and secVal_ is unused.
+  std::shared_ptr<SecValueBatch> secBatch_;
+  size_t secBatchOffset_ = 0;
 };
 
 // AggMetrics shared pointer.
@@ -10,6 +10,7 @@
 #include <fbpcf/exception/exceptions.h>
 #include <fbpcf/io/api/FileIOWrappers.h>
 #include <fbpcs/emp_games/common/Constants.h>
+#include <fbpcs/emp_games/common/MetricsBinaryFormat.h>
 #include <fbpcs/emp_games/common/TestUtil.h>
 #include <fbpcs/emp_games/pcf2_shard_combiner/AggMetrics.h>
 #include <fbpcs/emp_games/pcf2_shard_combiner/AggMetrics_impl.h>
@@ -146,6 +147,32 @@ TEST_F(AggMetricsTest, TestParseLift) {
   EXPECT_EQ(metrics->toDynamic(), parsedInput);
 }
 
+TEST_F(AggMetricsTest, TestParseBinary) {
+  auto inputPath =
+      baseDir_ + "shard_validation_test/valid_measurement_shard.json";
+
+  auto parsedInput =
+      folly::parseJson(fbpcf::io::FileIOWrappers::readFile(inputPath));
+  common::MetricsBinaryWriter writer;
+  common::writeMetricsBinary(writer, parsedInput);
+  auto binary = writer.finish();
+
+  auto metrics = AggMetrics<>::fromBinary(binary);
+  EXPECT_EQ(metrics->toDynamic(), parsedInput);
+  EXPECT_EQ(
+      metrics->getAtKey("last_click_1d")
+          ->getAtKey("measurement")
+          ->getAtKey("1")
+          ->getAtKey("convs")
+          ->getValue(),
+      -831273128088263600);
+
+  EXPECT_THROW(
+      AggMetrics<>::fromBinary(binary.substr(0, binary.size() - 1)),
+      std::runtime_error);
+  EXPECT_THROW(AggMetrics<>::fromBinary(binary + '\0'), std::runtime_error);
+}
+
 TEST_F(AggMetricsTest, TestParseInvalidMap) {
   auto inputPath = baseDir_ + "test_new_parser/invalid_map.json";
 
@@ -10,6 +10,7 @@
 #include <memory>
 #include <ostream>
 #include <queue>
+#include <stdexcept>
 #include <utility>
 
 #include <folly/FBString.h>
@@ -93,11 +94,11 @@ void AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulate(
     q_.pop();
     switch (rhsMetric->getType()) {
       case AggMetricType::kDict: {
-        auto lhsMetricMap = lhsMetric->getAsDict();
+        const auto& lhsMetricMap = lhsMetric->getAsDict();
         for (const auto& [key, innerMetricsRhs] : rhsMetric->getAsDict()) {
-          if (lhsMetricMap.find(key) != lhsMetricMap.end()) {
-            auto innerMetricLhs = lhsMetricMap.at(key);
-            q_.push(std::make_pair(innerMetricLhs, innerMetricsRhs));
+          auto innerMetricLhs = lhsMetricMap.find(key);
+          if (innerMetricLhs != lhsMetricMap.end()) {
+            q_.push(std::make_pair(innerMetricLhs->second, innerMetricsRhs));
           } else {
             // rhs has a key that lhs does not. We can simply assign it to lhs
             // as rhs usually used only once, so no need to copy. Also, no need
@@ -108,8 +109,8 @@ void AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulate(
         break;
       }
       case AggMetricType::kList: {
-        auto aggMetricList = lhsMetric->getAsList();
-        auto metricList = rhsMetric->getAsList();
+        const auto& aggMetricList = lhsMetric->getAsList();
+        const auto& metricList = rhsMetric->getAsList();
 
         if (aggMetricList.size() != metricList.size()) {
           XLOG(ERR) << "Rhs and Lhs list do not match in size";
@@ -129,6 +130,34 @@ void AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulate(
   }
 }
 
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+void AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulateLeaves(
+    const MetricsList& lhsLeaves,
+    const MetricsList& rhsLeaves) {
+  if (lhsLeaves.size() != rhsLeaves.size()) {
+    XLOG(ERR) << "Rhs and Lhs leaves do not match in size";
+    throw common::exceptions::SchemaTraceError(
+        "Rhs and Lhs leaves do not match in size");
+  }
+  if constexpr (
+      inputEncryption == common::InputEncryption::Xor && usingBatch) {
+    auto lhsBatch = getSharedSecBatch(lhsLeaves);
+    auto rhsBatch = getSharedSecBatch(rhsLeaves);
+    if (lhsBatch != nullptr && rhsBatch != nullptr) {
+      lhsBatch->value = lhsBatch->value + rhsBatch->value;
+      lhsBatch->unbatched.clear();
+      return;
+    }
+  }
+  for (size_t i = 0; i < lhsLeaves.size(); ++i) {
+    auto lhs = lhsLeaves.at(i);
+    accumulateFinal(lhs, rhsLeaves.at(i));
+  }
+}
+
 template <
     int schedulerId,
     bool usingBatch,
@@ -138,6 +167,24 @@ AggMetrics<schedulerId, usingBatch, inputEncryption>::getValue() const {
   return std::get<MetricsValue>(val_);
 }
 
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+SecInt<schedulerId, usingBatch>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::getSecValueXor() const {
+  if constexpr (usingBatch) {
+    if (secBatch_ != nullptr) {
+      if (secBatch_->unbatched.empty()) {
+        secBatch_->unbatched = secBatch_->value.unbatching(
+            std::make_shared<std::vector<uint32_t>>(secBatch_->size, 1));
+      }
+      return secBatch_->unbatched.at(secBatchOffset_);
+    }
+  }
+  return std::get<SecInt<schedulerId, usingBatch>>(secVal_);
+}
+
 template <
     int schedulerId,
     bool usingBatch,
@@ -392,7 +439,17 @@ template <
 std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
 AggMetrics<schedulerId, usingBatch, inputEncryption>::fromJson(
     std::string filePath) {
-  auto dynObj = folly::parseJson(fbpcf::io::FileIOWrappers::readFile(filePath));
+  return fromJsonData(fbpcf::io::FileIOWrappers::readFile(filePath));
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::fromJsonData(
+    const std::string& data) {
+  auto dynObj = folly::parseJson(data);
 
   using AggMetric_sp =
       std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>;
@@ -469,6 +526,71 @@ AggMetrics<schedulerId, usingBatch, inputEncryption>::fromJson(
   return retObj;
 }
 
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::fromBinary(
+    std::string_view data) {
+  common::MetricsBinaryReader reader{data};
+  auto retObj = readBinaryNode(reader);
+  if (!reader.done()) {
+    throw std::runtime_error("Trailing bytes after binary metrics");
+  }
+  return retObj;
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::readBinaryNode(
+    common::MetricsBinaryReader& reader) {
+  switch (reader.readType()) {
+    case common::MetricsNodeType::kValue: {
+      auto metric = std::make_shared<AggMetrics>(AggMetricType::kValue);
+      metric->setValue(reader.readValue());
+      return metric;
+    }
+    case common::MetricsNodeType::kList: {
+      auto metric = std::make_shared<AggMetrics>(AggMetricType::kList);
+      auto size = reader.readSize();
+      for (size_t i = 0; i < size; ++i) {
+        auto element = readBinaryNode(reader);
+        metric->pushBack(element);
+      }
+      return metric;
+    }
+    case common::MetricsNodeType::kDict: {
+      auto metric = std::make_shared<AggMetrics>(AggMetricType::kDict);
+      auto size = reader.readSize();
+      for (size_t i = 0; i < size; ++i) {
+        const auto& key = reader.readKey();
+        metric->insert(std::make_pair(key, readBinaryNode(reader)));
+      }
+      return metric;
+    }
+  }
+  throw common::exceptions::NotImplementedError(
+      "Binary metrics node type is not supported");
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::fromFile(
+    std::string filePath) {
+  auto data = fbpcf::io::FileIOWrappers::readFile(filePath);
+  if (common::isMetricsBinary(data)) {
+    return fromBinary(data);
+  }
+  return fromJsonData(data);
+}
+
 template <
     int schedulerId,
     bool usingBatch,
@@ -643,4 +765,125 @@ void AggMetrics<schedulerId, usingBatch, inputEncryption>::updateAllSecVals() {
   }
 }
 
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+std::shared_ptr<typename AggMetrics<schedulerId, usingBatch, inputEncryption>::
+                    SecValueBatch>
+AggMetrics<schedulerId, usingBatch, inputEncryption>::getSharedSecBatch(
+    const MetricsList& leaves) {
+  if (leaves.empty()) {
+    return nullptr;
+  }
+  auto secBatch = leaves.at(0)->secBatch_;
+  if (secBatch == nullptr || secBatch->size != leaves.size()) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    if (leaves.at(i)->secBatch_ != secBatch ||
+        leaves.at(i)->secBatchOffset_ != i) {
+      return nullptr;
+    }
+  }
+  return secBatch;
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+void AggMetrics<schedulerId, usingBatch, inputEncryption>::collectLeaves(
+    const std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>&
+        metric,
+    std::vector<
+        std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>>&
+        leaves) {
+  switch (metric->getType()) {
+    case AggMetricType::kDict: {
+      for (const auto& [k, v] : metric->getAsDict()) {
+        collectLeaves(v, leaves);
+      }
+      break;
+    }
+    case AggMetricType::kList: {
+      for (const auto& v : metric->getAsList()) {
+        collectLeaves(v, leaves);
+      }
+      break;
+    }
+    case AggMetricType::kValue: {
+      leaves.push_back(metric);
+      break;
+    }
+    default: {
+      std::string errStr = folly::sformat(
+          "Note match type received: {}", (int)metric->getType());
+      XLOG(ERR) << errStr;
+      throw common::exceptions::SchemaTraceError(errStr);
+      break;
+    }
+  }
+}
+
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+void AggMetrics<schedulerId, usingBatch, inputEncryption>::
+    updateAllSecValsBatched(
+        std::vector<std::shared_ptr<
+            AggMetrics<schedulerId, usingBatch, inputEncryption>>>& metrics) {
+  if constexpr (
+      inputEncryption == common::InputEncryption::Xor && usingBatch) {
+    std::vector<std::vector<
+        std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>>>
+        leavesPerMetric;
+    std::vector<uint32_t> batchSizes;
+    std::vector<int64_t> values;
+    for (const auto& metric : metrics) {
+      std::vector<std::shared_ptr<
+          AggMetrics<schedulerId, usingBatch, inputEncryption>>>
+          leaves;
+      collectLeaves(metric, leaves);
+      if (leaves.empty()) {
+        continue;
+      }
+      for (const auto& leaf : leaves) {
+        values.push_back(leaf->getValue());
+      }
+      batchSizes.push_back(leaves.size());
+      leavesPerMetric.push_back(std::move(leaves));
+    }
+    if (values.empty()) {
+      return;
+    }
+
+    typename SecInt<schedulerId, usingBatch>::ExtractedInt extractedInt(
+        values);
+    SecInt<schedulerId, usingBatch> batch(std::move(extractedInt));
+
+    std::vector<SecInt<schedulerId, usingBatch>> metricBatches;
+    if (batchSizes.size() == 1) {
+      metricBatches.push_back(std::move(batch));
+    } else {
+      metricBatches = batch.unbatching(
+          std::make_shared<std::vector<uint32_t>>(batchSizes));
+    }
+    for (size_t i = 0; i < leavesPerMetric.size(); ++i) {
+      auto secBatch = std::make_shared<SecValueBatch>(SecValueBatch{
+          std::move(metricBatches.at(i)), batchSizes.at(i), {}});
+      const auto& leaves = leavesPerMetric.at(i);
+      for (size_t j = 0; j < leaves.size(); ++j) {
+        leaves.at(j)->secBatch_ = secBatch;
+        leaves.at(j)->secBatchOffset_ = j;
+      }
+    }
+  } else {
+    for (const auto& metric : metrics) {
+      metric->updateAllSecVals();
+    }
+  }
+}
+
 } // namespace shard_combiner
@@ -81,13 +81,11 @@ class ShardCombinerApp {
 
     XLOG(INFO) << "Constructed game obj for: " << schedulerId;
 
-    // read shards in the game and populate secret vals
-    auto inputs = game.readShards(inputPath_, inputFilePrefix_, numShards_);
-
-    XLOG(INFO) << "Read input files: " << inputPath_ << "/" << inputFilePrefix_;
-
+    // read shards in the game, populate secret vals and fold each shard into
+    // the running accumulators as soon as it is read
     XLOG(INFO) << "Starting the Game: " << schedulerId;
-    auto resSecret = game.play(inputs);
+    auto resSecret =
+        game.playStreaming(inputPath_, inputFilePrefix_, numShards_);
     XLOG(INFO) << "Playing: " << inputPath_ << "/" << inputFilePrefix_;
 
     std::unordered_map<int32_t, folly::dynamic> ret;
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <folly/Format.h>
@@ -37,6 +38,7 @@ template <
 class ShardCombinerGame : public fbpcf::frontend::MpcGame<schedulerId> {
   using AggMetrics_sp =
       std::shared_ptr<AggMetrics<schedulerId, usingBatch, inputEncryption>>;
+  using ShardIndex_t = ShardIndex<schedulerId, usingBatch, inputEncryption>;
 
  public:
   ShardCombinerGame(
@@ -57,7 +59,27 @@ class ShardCombinerGame : public fbpcf::frontend::MpcGame<schedulerId> {
   static constexpr int64_t kAnonymityThreshold = 100;
 
   AggMetrics_sp play(std::vector<AggMetrics_sp>& inputData) {
-    reducer(inputData);
+    // Shards from readShards() were indexed while they were validated
+    bool indexedByReadShards = inputData.size() == shardIndices_.size() &&
+        std::equal(inputData.begin(), inputData.end(), shards_.begin());
+    std::vector<ShardIndex_t> indices;
+    if (indexedByReadShards) {
+      indices = std::move(shardIndices_);
+      shardIndices_.clear();
+    } else {
+      for (const auto& metrics : inputData) {
+        indices.push_back(
+            validateAndIndexShard<ShardSchemaType::kTest>(metrics));
+      }
+    }
+    return play(inputData, indices);
+  }
+
+  // Same as play(inputData), with the ShardIndex of each input
+  AggMetrics_sp play(
+      std::vector<AggMetrics_sp>& inputData,
+      std::vector<ShardIndex_t>& indices) {
+    reducer(inputData, indices);
 
     auto result = inputData.at(0); // reduced output is in the zeroth element.
 
@@ -83,7 +105,9 @@ class ShardCombinerGame : public fbpcf::frontend::MpcGame<schedulerId> {
    * Since, MPC's lazy scheduler internally parallelizes the ops that don't have
    * dependencies, we don't have need to launch a thread pool to realize this.
    */
-  void reducer(std::vector<AggMetrics_sp>& input) {
+  void reducer(
+      std::vector<AggMetrics_sp>& input,
+      std::vector<ShardIndex_t>& indices) {
     for (int step = 1;
          step < (input.size() % 2 == 0 ? input.size() : input.size() + 1);
          step <<= 1) {
@@ -92,38 +116,138 @@ class ShardCombinerGame : public fbpcf::frontend::MpcGame<schedulerId> {
            i += 2 * step) {
         // check second element is not out of the input array.
         if ((i + step) < input.size())
-          AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulate(
-              input.at(i), input.at(i + step));
+          fold(
+              input.at(i),
+              indices.at(i),
+              input.at(i + step),
+              indices.at(i + step));
       }
     }
   }
 
+  // Adds rhs to lhs. When both have the same layout their leaves are added
+  // position by position, in one batched addition if both were read by
+  // updateAllSecValsBatched(). Otherwise we fall back to matching keys and
+  // index lhs again, as it may have picked up new keys from rhs.
+  static void fold(
+      AggMetrics_sp& lhs,
+      ShardIndex_t& lhsIndex,
+      const AggMetrics_sp& rhs,
+      const ShardIndex_t& rhsIndex) {
+    if (lhsIndex.layout == rhsIndex.layout) {
+      AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulateLeaves(
+          lhsIndex.leaves, rhsIndex.leaves);
+    } else {
+      AggMetrics<schedulerId, usingBatch, inputEncryption>::accumulate(
+          lhs, rhs);
+      lhsIndex = validateAndIndexShard<ShardSchemaType::kTest>(lhs);
+    }
+  }
+
   // TODO: parallelize these reads, and  attach validation. That way things
   // are faster.
   std::vector<AggMetrics_sp>
   readShards(std::string inputDir, std::string filename, int32_t numShards) {
     shards_.clear();
+    shardIndices_.clear();
     for (int i = 0; i < numShards; i++) {
-      std::string fullPath = folly::sformat("{}/{}_{}", inputDir, filename, i);
-      auto shard =
-          AggMetrics<schedulerId, usingBatch, inputEncryption>::fromJson(
-              fullPath);
-      XLOG(INFO) << "parsed: " << fullPath;
-      validateShardSchema<shardSchemaType>(*shard);
-      XLOG(INFO) << "validated: " << fullPath;
-      shard->updateAllSecVals();
-      XLOG(INFO) << "updatedSecVals: " << fullPath;
-      shards_.push_back(shard);
+      auto [shard, index] = parseShard(inputDir, filename, i);
+      shards_.push_back(std::move(shard));
+      shardIndices_.push_back(std::move(index));
     }
+    // secret values of all shards are created in one batch
+    AggMetrics<schedulerId, usingBatch, inputEncryption>::
+        updateAllSecValsBatched(shards_);
+    XLOG(INFO) << "updatedSecVals for " << numShards << " shards";
     return shards_;
   }
 
+  /*
+   * Streaming alternative to readShards() followed by play(). Each shard is
+   * folded into one of at most numAccumulators running sums as soon as it is
+   * parsed and validated, and is released right after, so peak memory no
+   * longer grows with the number of shards. Shard i goes to accumulator
+   * i % numAccumulators, which bounds the length of each addition chain to
+   * numShards / numAccumulators; the accumulators are then combined with
+   * reducer().
+   */
+  AggMetrics_sp playStreaming(
+      std::string inputDir,
+      std::string filename,
+      int32_t numShards,
+      size_t numAccumulators = kDefaultNumAccumulators) {
+    if (numShards <= 0 || numAccumulators == 0) {
+      std::string errMsg = folly::sformat(
+          "Streaming combine needs at least one shard and one accumulator, got {} shards and {} accumulators",
+          numShards,
+          numAccumulators);
+      XLOG(ERR) << errMsg;
+      throw common::exceptions::InvalidArgumentError(errMsg);
+    }
+
+    std::vector<AggMetrics_sp> accumulators;
+    std::vector<ShardIndex_t> accumulatorIndices;
+    accumulators.reserve(
+        std::min(numAccumulators, static_cast<size_t>(numShards)));
+    // Shards are read in groups of numAccumulators, so that the secret values
+    // of each group are created in one batch
+    for (int start = 0; start < numShards; start += numAccumulators) {
+      int end =
+          std::min(numShards, static_cast<int32_t>(start + numAccumulators));
+      std::vector<AggMetrics_sp> group;
+      std::vector<ShardIndex_t> groupIndices;
+      for (int i = start; i < end; i++) {
+        auto [shard, index] = parseShard(inputDir, filename, i);
+        group.push_back(std::move(shard));
+        groupIndices.push_back(std::move(index));
+      }
+      AggMetrics<schedulerId, usingBatch, inputEncryption>::
+          updateAllSecValsBatched(group);
+      XLOG(INFO) << "updatedSecVals for shards " << start << " to "
+                 << start + group.size() - 1;
+
+      for (size_t j = 0; j < group.size(); j++) {
+        if (accumulators.size() < numAccumulators) {
+          accumulators.push_back(std::move(group.at(j)));
+          accumulatorIndices.push_back(std::move(groupIndices.at(j)));
+        } else {
+          fold(
+              accumulators.at(j),
+              accumulatorIndices.at(j),
+              group.at(j),
+              groupIndices.at(j));
+        }
+        XLOG(INFO) << "folded shard " << start + j << " into accumulator "
+                   << j;
+      }
+    }
+
+    return play(accumulators, accumulatorIndices);
+  }
+
+  static constexpr size_t kDefaultNumAccumulators = 8;
+
  private:
+  // parses and validates a shard, and indexes it in the same pass. Its secret
+  // values are not created yet.
+  std::pair<AggMetrics_sp, ShardIndex_t>
+  parseShard(const std::string& inputDir, const std::string& filename, int i) {
+    std::string fullPath = folly::sformat("{}/{}_{}", inputDir, filename, i);
+    auto shard =
+        AggMetrics<schedulerId, usingBatch, inputEncryption>::fromFile(
+            fullPath);
+    XLOG(INFO) << "parsed: " << fullPath;
+    auto index = validateAndIndexShard<shardSchemaType>(shard);
+    XLOG(INFO) << "validated: " << fullPath;
+    return {std::move(shard), std::move(index)};
+  }
+
   common::InputEncryption inputEncryption_;
   std::shared_ptr<fbpcf::engine::communication::IPartyCommunicationAgentFactory>
       communicationAgentFactory_;
   int concurrency_;
   std::vector<AggMetrics_sp> shards_;
+  std::vector<ShardIndex_t> shardIndices_;
 
   std::function<void(AggMetrics_sp)> thresholdFn_;
 };
@@ -19,6 +19,7 @@
 #include <fbpcf/io/api/FileIOWrappers.h>
 
 #include "fbpcs/emp_games/common/Constants.h"
+#include "fbpcs/emp_games/common/MetricsBinaryFormat.h"
 #include "fbpcs/emp_games/common/test/TestUtils.h"
 #include "fbpcs/emp_games/pcf2_shard_combiner/AggMetrics.h"
 #include "fbpcs/emp_games/pcf2_shard_combiner/AggMetrics_impl.h"
@@ -64,14 +65,21 @@ std::unordered_map<int32_t, folly::dynamic> runGameTest(
     int32_t numShards,
     std::shared_ptr<
         fbpcf::engine::communication::IPartyCommunicationAgentFactory> factory,
-    fbpcf::SchedulerCreator schedulerCreator) {
+    fbpcf::SchedulerCreator schedulerCreator,
+    size_t numStreamingAccumulators) {
   auto game = getGameInstance<
       shardSchemaType,
       schedulerId,
       usingBatch,
       inputEncryption>(factory, schedulerCreator);
-  auto new_metrics = game->readShards(inputDir, filename, numShards);
-  auto res = game->play(new_metrics);
+  AggMetrics_sp<schedulerId, usingBatch, inputEncryption> res;
+  if (numStreamingAccumulators > 0) {
+    res = game->playStreaming(
+        inputDir, filename, numShards, numStreamingAccumulators);
+  } else {
+    auto new_metrics = game->readShards(inputDir, filename, numShards);
+    res = game->play(new_metrics);
+  }
 
   std::unordered_map<int32_t, folly::dynamic> ret;
   ret.insert(std::make_pair(
@@ -91,7 +99,8 @@ void runTestWithParams(
     std::string partnerFileName,
     std::string publisherFileName,
     int32_t numShards,
-    std::string expectedOutFileName) {
+    std::string expectedOutFileName,
+    size_t numStreamingAccumulators = 0) {
   constexpr common::InputEncryption inputEncryption =
       common::InputEncryption::Xor;
 
@@ -111,7 +120,8 @@ void runTestWithParams(
       partnerFileName,
       numShards,
       std::move(factories[common::PARTNER]),
-      schedulerCreator);
+      schedulerCreator,
+      numStreamingAccumulators);
 
   auto gamePublisher = std::async(
       std::launch::async,
@@ -124,7 +134,8 @@ void runTestWithParams(
       publisherFileName,
       numShards,
       std::move(factories[common::PUBLISHER]),
-      schedulerCreator);
+      schedulerCreator,
+      numStreamingAccumulators);
 
   auto f1 = gamePartner.get();
   auto f2 = gamePublisher.get();
@@ -233,6 +244,62 @@ void runTestReadFiles(
   testFn(f2, common::PUBLISHER);
 }
 
+// Reads three metrics in one batch and adds the second to the first twice,
+// revealing the first in between so that its leaves are split off their
+// batch. If detachRhsLeaf is set, the first leaf of the second metric gets a
+// secret value of its own beforehand, so the leaves are added one by one.
+// Returns the revealed metrics after the first and the second addition,
+// followed by the second and third metrics.
+template <int32_t schedulerId>
+std::vector<folly::dynamic> accumulateBatchedLeaves(
+    std::shared_ptr<
+        fbpcf::engine::communication::IPartyCommunicationAgentFactory> factory,
+    fbpcf::SchedulerCreator schedulerCreator,
+    bool detachRhsLeaf) {
+  constexpr common::InputEncryption inputEncryption =
+      common::InputEncryption::Xor;
+  using Metrics = AggMetrics<schedulerId, true, inputEncryption>;
+  auto game = getGameInstance<
+      ShardSchemaType::kTest,
+      schedulerId,
+      true,
+      inputEncryption>(factory, schedulerCreator);
+
+  // the publisher holds the values and the partner's shares are zero
+  auto share = [](int64_t value) -> int64_t {
+    return schedulerId == common::PUBLISHER ? value : 0;
+  };
+  auto fromDynamic = [](const folly::dynamic& obj) {
+    common::MetricsBinaryWriter writer;
+    common::writeMetricsBinary(writer, obj);
+    return Metrics::fromBinary(writer.finish());
+  };
+  std::vector<AggMetrics_sp<schedulerId, true, inputEncryption>> metrics{
+      fromDynamic(folly::dynamic::object("a", share(1))(
+          "b", folly::dynamic::array(share(2), share(3)))),
+      fromDynamic(folly::dynamic::object("a", share(10))(
+          "b", folly::dynamic::array(share(20), share(30)))),
+      fromDynamic(folly::dynamic::object("c", share(5)))};
+  Metrics::updateAllSecValsBatched(metrics);
+
+  auto lhsIndex = validateAndIndexShard<ShardSchemaType::kTest>(metrics.at(0));
+  auto rhsIndex = validateAndIndexShard<ShardSchemaType::kTest>(metrics.at(1));
+  if (detachRhsLeaf) {
+    auto secVal = rhsIndex.leaves.at(0)->getSecValueXor();
+    rhsIndex.leaves.at(0)->setSecValueXor(secVal);
+  }
+
+  Metrics::accumulateLeaves(lhsIndex.leaves, rhsIndex.leaves);
+  auto afterFirst = metrics.at(0)->toRevealedDynamic(common::PUBLISHER);
+  Metrics::accumulateLeaves(lhsIndex.leaves, rhsIndex.leaves);
+
+  return {
+      afterFirst,
+      metrics.at(0)->toRevealedDynamic(common::PUBLISHER),
+      metrics.at(1)->toRevealedDynamic(common::PUBLISHER),
+      metrics.at(2)->toRevealedDynamic(common::PUBLISHER)};
+}
+
 class ShardCombinerGameTestFixture
     : public ::testing::TestWithParam<std::tuple<common::SchedulerType, bool>> {
  protected:
@@ -343,7 +410,8 @@ TEST_P(ShardCombinerGameTestFixture, TestThresholdChecker) {
   std::string expectedOutFileNamePrefix = "lift_expected_output_shards_";
   auto testFn = [&](int32_t numShards,
                     bool usingBatch,
-                    common::SchedulerType schedulerType) {
+                    common::SchedulerType schedulerType,
+                    size_t numStreamingAccumulators) {
     std::string expectedOutFileName =
         folly::sformat("{}{}.json", expectedOutFileNamePrefix, numShards);
     if (usingBatch) {
@@ -353,7 +421,8 @@ TEST_P(ShardCombinerGameTestFixture, TestThresholdChecker) {
           partnerFileName,
           publisherFileName,
           numShards,
-          expectedOutFileName);
+          expectedOutFileName,
+          numStreamingAccumulators);
     } else {
       runTestWithParams<false, ShardSchemaType::kGroupedLiftMetrics>(
           schedulerType,
@@ -361,11 +430,55 @@ TEST_P(ShardCombinerGameTestFixture, TestThresholdChecker) {
           partnerFileName,
           publisherFileName,
           numShards,
-          expectedOutFileName);
+          expectedOutFileName,
+          numStreamingAccumulators);
     }
   };
-  testFn(2, usingBatch, schedulerType);
-  testFn(3, usingBatch, schedulerType);
+  testFn(2, usingBatch, schedulerType, 0);
+  testFn(3, usingBatch, schedulerType, 0);
+  // Streaming combine with fewer accumulators than shards
+  testFn(3, usingBatch, schedulerType, 2);
+}
+
+// This test checks that leaves read in one batch are added batch by batch,
+// and that the sums stay correct once single leaves are read or replaced.
+TEST_P(ShardCombinerGameTestFixture, TestAccumulateBatchedLeaves) {
+  auto [schedulerType, usingBatch] = GetParam();
+  if (!usingBatch) {
+    GTEST_SKIP();
+  }
+
+  for (bool detachRhsLeaf : {false, true}) {
+    auto factories = fbpcf::engine::communication::getInMemoryAgentFactory(2);
+    fbpcf::SchedulerCreator schedulerCreator =
+        fbpcf::getSchedulerCreator<true>(schedulerType);
+
+    auto gamePartner = std::async(
+        std::launch::async,
+        accumulateBatchedLeaves<common::PARTNER>,
+        std::move(factories[common::PARTNER]),
+        schedulerCreator,
+        detachRhsLeaf);
+    auto gamePublisher = std::async(
+        std::launch::async,
+        accumulateBatchedLeaves<common::PUBLISHER>,
+        std::move(factories[common::PUBLISHER]),
+        schedulerCreator,
+        detachRhsLeaf);
+    gamePartner.get();
+    auto result = gamePublisher.get();
+
+    EXPECT_EQ(
+        result.at(0),
+        folly::dynamic::object("a", 11)("b", folly::dynamic::array(22, 33)));
+    EXPECT_EQ(
+        result.at(1),
+        folly::dynamic::object("a", 21)("b", folly::dynamic::array(42, 63)));
+    EXPECT_EQ(
+        result.at(2),
+        folly::dynamic::object("a", 10)("b", folly::dynamic::array(20, 30)));
+    EXPECT_EQ(result.at(3), folly::dynamic::object("c", 5));
+  }
 }
 
 INSTANTIATE_TEST_SUITE_P(
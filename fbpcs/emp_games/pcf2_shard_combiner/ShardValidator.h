@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+#include <vector>
+
 #include <fbpcs/emp_games/common/Constants.h>
 #include <fbpcs/emp_games/pcf2_shard_combiner/AggMetrics.h>
 
@@ -14,6 +18,39 @@ namespace shard_combiner {
 
 enum class ShardSchemaType { kTest, kAdObjFormat, kGroupedLiftMetrics };
 
+// Constraints on the metrics found at one depth of a shard, the root being at
+// depth 0.
+struct ShardSchemaLevel {
+  bool isDict = false;
+  bool isNonEmpty = false;
+  // if set, the only key a metric at this depth may have in its parent dict.
+  std::optional<std::string> name;
+  // keys a metric at this depth has to contain.
+  std::vector<std::string> requiredKeys;
+};
+
+// One ShardSchemaLevel per depth, deeper metrics are not constrained.
+using CompiledShardSchema = std::vector<ShardSchemaLevel>;
+
+// Schema for shardSchemaType, compiled on first use.
+template <ShardSchemaType shardSchemaType>
+const CompiledShardSchema& getCompiledShardSchema();
+
+// Flat view of a shard built while it is validated: its kValue leaves in
+// depth-first order and a layout string which spells out every key, list size
+// and metric type on the way. Two shards with the same layout have matching
+// leaves at the same positions, so the reducer can add them leaf by leaf
+// instead of matching up their keys.
+template <
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+struct ShardIndex {
+  std::string layout;
+  typename AggMetrics<schedulerId, usingBatch, inputEncryption>::MetricsList
+      leaves;
+};
+
 template <
     ShardSchemaType shardSchemaType,
     int schedulerId,
@@ -22,4 +59,14 @@ template <
 void validateShardSchema(
     const AggMetrics<schedulerId, usingBatch, inputEncryption>& metrics);
 
+// Validates metrics like validateShardSchema and builds its ShardIndex in the
+// same traversal.
+template <
+    ShardSchemaType shardSchemaType,
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+ShardIndex<schedulerId, usingBatch, inputEncryption> validateAndIndexShard(
+    const AggMetrics_sp<schedulerId, usingBatch, inputEncryption>& metrics);
+
 } // namespace shard_combiner
@@ -119,4 +119,36 @@ TEST_F(ShardValidatorTest, LiftTestValidInputEmptyCohortMetrics) {
   validateShardSchema<ShardSchemaType::kGroupedLiftMetrics>(*testMetricsObj);
 }
 
+TEST_F(ShardValidatorTest, IndexedShardsAccumulateLikeNestedMetrics) {
+  std::string inputDir = baseDir_ + "../test_new_parser/";
+  using Metrics = AggMetrics<schedulerId, usingBatch, inputEncryption>;
+  auto lhs = Metrics::fromJson(
+      inputDir + "accumulate_test_input_plaintext_1.json");
+  auto rhs = Metrics::fromJson(
+      inputDir + "accumulate_test_input_plaintext_2.json");
+  auto expected =
+      Metrics::fromJson(inputDir + "accumulate_test_result_plaintext.json");
+
+  auto lhsIndex = validateAndIndexShard<ShardSchemaType::kTest>(lhs);
+  auto rhsIndex = validateAndIndexShard<ShardSchemaType::kTest>(rhs);
+  EXPECT_EQ(lhsIndex.layout, rhsIndex.layout);
+  EXPECT_EQ(lhsIndex.leaves.size(), 2);
+
+  Metrics::accumulateLeaves(lhsIndex.leaves, rhsIndex.leaves);
+  EXPECT_EQ(lhs->toDynamic(), expected->toDynamic());
+}
+
+TEST_F(ShardValidatorTest, IndexLayoutDiffersAcrossSchemas) {
+  using Metrics = AggMetrics<schedulerId, usingBatch, inputEncryption>;
+  auto measurement =
+      Metrics::fromJson(baseDir_ + "valid_measurement_shard.json");
+  auto lift = Metrics::fromJson(baseDir_ + "valid_lift_input.json");
+  EXPECT_NE(
+      validateAndIndexShard<ShardSchemaType::kTest>(measurement).layout,
+      validateAndIndexShard<ShardSchemaType::kTest>(lift).layout);
+  EXPECT_THROW(
+      validateAndIndexShard<ShardSchemaType::kGroupedLiftMetrics>(measurement),
+      common::exceptions::SchemaTraceError);
+}
+
 } // namespace shard_combiner
@@ -19,6 +19,11 @@
     }                                                                  \
   } while (0)
 
+#include <string>
+
+#include <folly/Format.h>
+#include <folly/logging/xlog.h>
+
 #include <fbpcf/exception/exceptions.h>
 
 #include "fbpcs/emp_games/pcf2_shard_combiner/AggMetrics.h"
@@ -27,109 +32,155 @@
 
 namespace shard_combiner {
 
-template <
-    ShardSchemaType shardSchemaType,
-    int schedulerId,
-    bool usingBatch,
-    common::InputEncryption inputEncryption>
-void validateShardSchema(
-    const AggMetrics<schedulerId, usingBatch, inputEncryption>& metrics) {
-  if constexpr (shardSchemaType == ShardSchemaType::kAdObjFormat) {
-    validateAdObjectFormatMetrics(metrics);
-  } else if constexpr (
-      shardSchemaType == ShardSchemaType::kGroupedLiftMetrics) {
-    validateGroupedLiftMetrics(metrics);
-  } else if constexpr (shardSchemaType == ShardSchemaType::kTest) {
-    /* Do nothing for test shards */
-  } else {
-    throw common::exceptions::SchemaTraceError(folly::sformat(
-        "This [{}] schema is currently not supported in pcf2_shard_combiner.",
-        shardSchemaType));
-  }
+template <ShardSchemaType shardSchemaType>
+const CompiledShardSchema& getCompiledShardSchema() {
+  static const CompiledShardSchema schema = []() {
+    if constexpr (shardSchemaType == ShardSchemaType::kAdObjFormat) {
+      // rule -> aggregation name -> aggregation
+      ShardSchemaLevel root{.isDict = true, .isNonEmpty = true};
+      ShardSchemaLevel rule{.isDict = true, .isNonEmpty = true};
+      ShardSchemaLevel aggregation{.isDict = true, .name = "measurement"};
+      return CompiledShardSchema{root, rule, aggregation};
+    } else if constexpr (
+        shardSchemaType == ShardSchemaType::kGroupedLiftMetrics) {
+      ShardSchemaLevel root{
+          .isDict = true,
+          .requiredKeys = {"metrics", "cohortMetrics", "publisherBreakdowns"}};
+      return CompiledShardSchema{root};
+    } else {
+      /* Nothing to check for test shards */
+      return CompiledShardSchema{};
+    }
+  }();
+  return schema;
 }
 
+namespace detail {
+
+// Checks metrics against the schema level of its depth and, if index is set,
+// appends its layout and leaves to it. Without an index the traversal stops
+// below the last schema level.
 template <
     int schedulerId,
     bool usingBatch,
     common::InputEncryption inputEncryption>
-void validateAdObjectFormatMetrics(
-    const AggMetrics<schedulerId, usingBatch, inputEncryption>& metrics) {
-  VALIDATE_OR_THROW(
-      metrics.getAsDict().size(),
-      >,
-      0,
-      common::exceptions::SchemaTraceError,
-      "Metrics cannot have an empty dictionary.");
-  for (const auto& [rule, metricsEntry] : metrics.getAsDict()) {
-    VALIDATE_OR_THROW(
-        metricsEntry->getType(),
-        ==,
-        AggMetricType::kDict,
-        common::exceptions::SchemaTraceError,
-        folly::sformat("Metrics rule: {} should be a dictionary.", rule));
-
-    VALIDATE_OR_THROW(
-        metricsEntry->getAsDict().size(),
-        >,
-        0,
-        common::exceptions::SchemaTraceError,
-        folly::sformat(
-            "Metrics rule: {} should be a dictionary of size > 0.", rule));
-
-    for (const auto& [aggregationName, aggregationData] :
-         metricsEntry->getAsDict()) {
+void validateAndIndexMetrics(
+    const CompiledShardSchema& schema,
+    const AggMetrics<schedulerId, usingBatch, inputEncryption>& metrics,
+    const std::string& name,
+    size_t depth,
+    ShardIndex<schedulerId, usingBatch, inputEncryption>* index) {
+  if (depth < schema.size()) {
+    const auto& level = schema.at(depth);
+    if (level.name.has_value()) {
       VALIDATE_OR_THROW(
-          aggregationName,
+          name,
           ==,
-          "measurement",
+          *level.name,
           common::exceptions::SchemaTraceError,
           folly::sformat(
-              "Unsupported aggregationName [{}] passed to Shard Aggregator",
-              aggregationName));
+              "Unsupported key [{}] at depth {}, expected [{}]",
+              name,
+              depth,
+              *level.name));
+    }
+    if (level.isDict) {
       VALIDATE_OR_THROW(
-          aggregationData->getType(),
+          metrics.getType(),
           ==,
           AggMetricType::kDict,
           common::exceptions::SchemaTraceError,
           folly::sformat(
-              "Aggregation should be a Dictionary({}), got: [{}]",
+              "Metrics [{}] should be a Dictionary({}), got: [{}]",
+              name,
               (int)AggMetricType::kDict,
-              (int)aggregationData->getType()));
+              (int)metrics.getType()));
+    }
+    if (level.isNonEmpty) {
+      VALIDATE_OR_THROW(
+          metrics.getAsDict().size(),
+          >,
+          0,
+          common::exceptions::SchemaTraceError,
+          folly::sformat(
+              "Metrics [{}] should be a dictionary of size > 0.", name));
+    }
+    for (const auto& key : level.requiredKeys) {
+      VALIDATE_OR_THROW(
+          metrics.getAsDict().find(key),
+          !=,
+          metrics.getAsDict().end(),
+          common::exceptions::SchemaTraceError,
+          folly::sformat("Dict [{}] does not have '{}' key", name, key));
+    }
+  } else if (index == nullptr) {
+    return;
+  }
+
+  auto visit = [&](const std::string& childName, const auto& child) {
+    if (index != nullptr && child->getType() == AggMetricType::kValue) {
+      index->leaves.push_back(child);
+    }
+    validateAndIndexMetrics(schema, *child, childName, depth + 1, index);
+  };
+
+  switch (metrics.getType()) {
+    case AggMetricType::kDict: {
+      if (index != nullptr) {
+        index->layout += folly::sformat("d{}:", metrics.getAsDict().size());
+      }
+      for (const auto& [key, child] : metrics.getAsDict()) {
+        if (index != nullptr) {
+          index->layout += key;
+          index->layout.push_back('\0');
+        }
+        visit(key, child);
+      }
+      break;
+    }
+    case AggMetricType::kList: {
+      if (index != nullptr) {
+        index->layout += folly::sformat("l{}:", metrics.getAsList().size());
+      }
+      for (const auto& child : metrics.getAsList()) {
+        visit(name, child);
+      }
+      break;
+    }
+    case AggMetricType::kValue: {
+      if (index != nullptr) {
+        index->layout.push_back('v');
+      }
+      break;
     }
   }
 }
+} // namespace detail
 
 template <
+    ShardSchemaType shardSchemaType,
     int schedulerId,
     bool usingBatch,
     common::InputEncryption inputEncryption>
-void validateGroupedLiftMetrics(
+void validateShardSchema(
     const AggMetrics<schedulerId, usingBatch, inputEncryption>& metrics) {
-  VALIDATE_OR_THROW(
-      metrics.getType(),
-      ==,
-      AggMetricType::kDict,
-      common::exceptions::SchemaTraceError,
-      folly::sformat(
-          "GroupedLiftMetrics expects dictionary as input, got: [{}]",
-          (int)metrics.getType()));
-  VALIDATE_OR_THROW(
-      metrics.getAsDict().find("metrics"),
-      !=,
-      metrics.getAsDict().end(),
-      common::exceptions::SchemaTraceError,
-      "Dict does not have 'metrics' key");
-  VALIDATE_OR_THROW(
-      metrics.getAsDict().find("cohortMetrics"),
-      !=,
-      metrics.getAsDict().end(),
-      common::exceptions::SchemaTraceError,
-      "Dict does not have 'cohortMetrics' key, maybe SchemaType is wrong?");
-  VALIDATE_OR_THROW(
-      metrics.getAsDict().find("publisherBreakdowns"),
-      !=,
-      metrics.getAsDict().end(),
-      common::exceptions::SchemaTraceError,
-      "Dict does not have 'publisherBreakdowns' key");
+  detail::validateAndIndexMetrics<schedulerId, usingBatch, inputEncryption>(
+      getCompiledShardSchema<shardSchemaType>(), metrics, "", 0, nullptr);
+}
+
+template <
+    ShardSchemaType shardSchemaType,
+    int schedulerId,
+    bool usingBatch,
+    common::InputEncryption inputEncryption>
+ShardIndex<schedulerId, usingBatch, inputEncryption> validateAndIndexShard(
+    const AggMetrics_sp<schedulerId, usingBatch, inputEncryption>& metrics) {
+  ShardIndex<schedulerId, usingBatch, inputEncryption> index;
+  if (metrics->getType() == AggMetricType::kValue) {
+    index.leaves.push_back(metrics);
+  }
+  detail::validateAndIndexMetrics(
+      getCompiledShardSchema<shardSchemaType>(), *metrics, "", 0, &index);
+  return index;
 }
 } // namespace shard_combiner